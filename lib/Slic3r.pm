@@ -51,7 +51,6 @@ use Slic3r::GCode;
 use Slic3r::GCode::ArcFitting;
 use Slic3r::GCode::CoolingBuffer;
 use Slic3r::GCode::Layer;
-use Slic3r::GCode::MotionPlanner;
 use Slic3r::GCode::Reader;
 use Slic3r::GCode::SpiralVase;
 use Slic3r::GCode::VibrationLimit;
@@ -81,6 +80,7 @@ use constant SMALL_PERIMETER_LENGTH => (6.5 / SCALING_FACTOR) * 2 * PI;
 use constant LOOP_CLIPPING_LENGTH_OVER_SPACING      => 0.15;
 use constant INFILL_OVERLAP_OVER_SPACING  => 0.45;
 use constant EXTERNAL_INFILL_MARGIN => 3;
+use constant OFFSET_CACHE_SIZE      => 256;  # offset results memoized by each thread (0 to disable)
 
 our $Config;
 
@@ -133,11 +133,18 @@ sub parallelize {
 sub thread_cleanup {
     # prevent destruction of shared objects
     no warnings 'redefine';
+    *Slic3r::BridgeDetector::DESTROY        = sub {};
     *Slic3r::ExPolygon::DESTROY             = sub {};
     *Slic3r::ExPolygon::Collection::DESTROY = sub {};
+    *Slic3r::ExPolygon::Collection::Index::DESTROY = sub {};
     *Slic3r::ExtrusionLoop::DESTROY         = sub {};
     *Slic3r::ExtrusionPath::DESTROY         = sub {};
     *Slic3r::ExtrusionPath::Collection::DESTROY = sub {};
+    *Slic3r::GCode::MotionPlanner::DESTROY = sub {};
+    *Slic3r::Geometry::BoundingBox::DESTROY = sub {};
+    *Slic3r::Geometry::BoundingBox3::DESTROY = sub {};
+    *Slic3r::Geometry::ConvexHull::DESTROY  = sub {};
+    *Slic3r::Layer::PerimeterGenerator::DESTROY = sub {};
     *Slic3r::Line::DESTROY                  = sub {};
     *Slic3r::Point::DESTROY                 = sub {};
     *Slic3r::Polygon::DESTROY               = sub {};
@@ -145,6 +152,7 @@ sub thread_cleanup {
     *Slic3r::Polyline::Collection::DESTROY  = sub {};
     *Slic3r::Surface::DESTROY               = sub {};
     *Slic3r::Surface::Collection::DESTROY   = sub {};
+    *Slic3r::SurfaceTypeDetector::DESTROY   = sub {};
     *Slic3r::TriangleMesh::DESTROY          = sub {};
     return undef;  # this prevents a "Scalars leaked" warning
 }
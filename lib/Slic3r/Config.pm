@@ -596,7 +596,7 @@ our $Options = {
         cli     => 'fill-pattern=s',
         type    => 'select',
         values  => [qw(rectilinear line concentric honeycomb hilbertcurve archimedeanchords octagramspiral)],
-        labels  => [qw(rectilinear line concentric honeycomb), 'hilbertcurve (slow)', 'archimedeanchords (slow)', 'octagramspiral (slow)'],
+        labels  => [qw(rectilinear line concentric honeycomb hilbertcurve archimedeanchords octagramspiral)],
         default => 'rectilinear',
     },
     'solid_fill_pattern' => {
@@ -607,7 +607,7 @@ our $Options = {
         cli     => 'solid-fill-pattern=s',
         type    => 'select',
         values  => [qw(rectilinear concentric hilbertcurve archimedeanchords octagramspiral)],
-        labels  => [qw(rectilinear concentric), 'hilbertcurve (slow)', 'archimedeanchords (slow)', 'octagramspiral (slow)'],
+        labels  => [qw(rectilinear concentric hilbertcurve archimedeanchords octagramspiral)],
         default => 'rectilinear',
     },
     'fill_density' => {
@@ -696,6 +696,15 @@ our $Options = {
         type    => 'bool',
         default => 0,
     },
+    'travel_optimization' => {
+        label   => 'Travel optimization effort',
+        tooltip => 'After infill and support paths are ordered by nearest neighbor, try up to this number of reorderings per path that shorten the travel moves between them. Higher values give shorter travel moves but slow down the G-code generation. Set to zero to disable.',
+        sidetext => 'moves per path',
+        cli     => 'travel-optimization=i',
+        type    => 'i',
+        min     => 0,
+        default => 1000,
+    },
     'external_perimeters_first' => {
         label   => 'External perimeters first',
         tooltip => 'Print contour perimeters from the outermost one to the innermost one instead of the default inverse order.',
@@ -4,7 +4,6 @@ use Moo;
 use Slic3r::Fill::ArchimedeanChords;
 use Slic3r::Fill::Base;
 use Slic3r::Fill::Concentric;
-use Slic3r::Fill::Flowsnake;
 use Slic3r::Fill::HilbertCurve;
 use Slic3r::Fill::Honeycomb;
 use Slic3r::Fill::Line;
@@ -23,7 +22,6 @@ has 'fillers'   => (is => 'rw', default => sub { {} });
 our %FillTypes = (
     archimedeanchords   => 'Slic3r::Fill::ArchimedeanChords',
     rectilinear         => 'Slic3r::Fill::Rectilinear',
-    flowsnake           => 'Slic3r::Fill::Flowsnake',
     octagramspiral      => 'Slic3r::Fill::OctagramSpiral',
     hilbertcurve        => 'Slic3r::Fill::HilbertCurve',
     line                => 'Slic3r::Fill::Line',
@@ -50,6 +48,8 @@ sub make_fill {
     my ($layerm) = @_;
     
     Slic3r::debugf "Filling layer %d:\n", $layerm->id;
+    Slic3r::Geometry::Clipper::offset_cache_clear();  # cached offsets are scoped to a layer
+    Slic3r::Fill::cache_clear();
     my $fill_density = $layerm->config->fill_density;
     
     my @surfaces = ();
@@ -185,17 +185,17 @@ sub make_fill {
                 flow_spacing => $params->{flow_spacing} || (warn "Warning: no flow_spacing was returned by the infill engine, please report this to the developer\n"),
             ), @polylines,
         );
-        push @fills_ordering_points, $polylines[0]->first_point;
+        push @fills_ordering_points, [ $polylines[0]->first_point_xy ];
     }
     
     # add thin fill regions
     if ($layerm->thin_fills->count > 0) {
         push @fills, Slic3r::ExtrusionPath::Collection->new(@{$layerm->thin_fills});
-        push @fills_ordering_points, $fills[-1]->first_point;
+        push @fills_ordering_points, [ $fills[-1]->first_point_xy ];
     }
     
-    # organize infill paths using a nearest-neighbor search
-    @fills = @fills[ @{chained_path(\@fills_ordering_points)} ];
+    # organize infill paths using a nearest-neighbor search, then shorten the travel
+    @fills = @fills[ @{chained_path(\@fills_ordering_points, 1)} ];
     
     return @fills;
 }
@@ -3,21 +3,12 @@ use Moo;
 
 extends 'Slic3r::Fill::Base';
 
-use Slic3r::Geometry qw(scale X1 Y1 X2 Y2);
-use Slic3r::Geometry::Clipper qw(intersection_pl);
+use Slic3r::Geometry qw(scale);
 
 sub multiplier () { 1 }
 
-sub get_n {
-    my $self = shift;
-    my ($path, $bounding_box) = @_;
-    
-    my ($n_lo, $n_hi) = $path->rect_to_n_range(@$bounding_box);
-    return ($n_lo .. $n_hi);
-}
-
-sub process_polyline {}
-
+# curves are generated around the surface and clipped in XS (see Slic3r::Fill::fill_plane_path);
+# subclasses are named after the curve they follow
 sub fill_surface {
     my $self = shift;
     my ($surface, %params) = @_;
@@ -28,28 +19,9 @@ sub fill_surface {
     $self->rotate_points($expolygon, $rotate_vector);
     
     my $distance_between_lines = scale $params{flow_spacing} / $params{density} * $self->multiplier;
-    my $bounding_box = $expolygon->bounding_box;
     
     (ref $self) =~ /::([^:]+)$/;
-    my $path = "Math::PlanePath::$1"->new;
-    my @n = $self->get_n($path, [ map +($_ / $distance_between_lines), @{$bounding_box->bb} ]);
-    
-    my $polyline = Slic3r::Polyline->new(
-        map [ map {$_*$distance_between_lines} $path->n_to_xy($_) ], @n,
-    );
-    return {} if @$polyline <= 1;
-    
-    $self->process_polyline($polyline, $bounding_box);
-    
-    my @paths = @{intersection_pl([$polyline], \@$expolygon)};
-    
-    if (0) {
-        require "Slic3r/SVG.pm";
-        Slic3r::SVG::output("fill.svg",
-            polygons => $expolygon,
-            polylines => [map $_->p, @paths],
-        );
-    }
+    my @paths = Slic3r::Fill::fill_plane_path($expolygon, $distance_between_lines, $1);
     
     # paths must be rotated back
     $self->rotate_points_back(\@paths, $rotate_vector);
@@ -16,9 +16,11 @@ has 'enable_loop_clipping' => (is => 'rw', default => sub {1});
 has 'enable_wipe'        => (is => 'lazy');   # at least one extruder has wipe enabled
 has 'layer_count'        => (is => 'ro', required => 1 );
 has 'layer'              => (is => 'rw');
-has '_layer_islands'     => (is => 'rw');
-has '_upper_layer_islands'  => (is => 'rw');
+has '_layer_islands'     => (is => 'rw');   # ExPolygon::Collection::Index
+has '_upper_layer_islands'  => (is => 'rw');   # ExPolygon::Collection::Index
+has '_support_islands'   => (is => 'rw');   # ExPolygon::Collection::Index
 has '_layer_overhangs'   => (is => 'ro', default => sub { Slic3r::ExPolygon::Collection->new });
+has '_layer_overhangs_index' => (is => 'rw');
 has 'shift_x'            => (is => 'rw', default => sub {0} );
 has 'shift_y'            => (is => 'rw', default => sub {0} );
 has 'z'                  => (is => 'rw');
@@ -93,15 +95,25 @@ sub change_layer {
     
     $self->layer($layer);
     
-    # avoid computing islands and overhangs if they're not needed
-    $self->_layer_islands($layer->islands);
-    $self->_upper_layer_islands($layer->upper_layer ? $layer->upper_layer->islands : []);
+    # avoid computing islands and overhangs if they're not needed;
+    # islands are indexed once here and then queried for each move
+    if ($self->config->only_retract_when_crossing_perimeters) {
+        $self->_layer_islands(Slic3r::ExPolygon::Collection::Index->new(@{$layer->islands}));
+        $self->_upper_layer_islands(Slic3r::ExPolygon::Collection::Index->new(
+            $layer->upper_layer ? @{$layer->upper_layer->islands} : ()
+        ));
+    }
+    $self->_support_islands($layer->isa('Slic3r::Layer::Support')
+        ? Slic3r::ExPolygon::Collection::Index->new(@{$layer->support_islands})
+        : undef);
     $self->_layer_overhangs->clear;
+    $self->_layer_overhangs_index(undef);
     if ($layer->id > 0 && ($layer->config->overhangs || $Slic3r::Config->start_perimeters_at_non_overhang)) {
         $self->_layer_overhangs->append(
             # clone ExPolygons because they come from Surface objects but will be used outside here
             map $_->expolygon, map @{$_->slices->filter_by_type(S_TYPE_BOTTOM)}, @{$layer->regions}
         );
+        $self->_layer_overhangs_index(Slic3r::ExPolygon::Collection::Index->new(@{$self->_layer_overhangs}));
     }
     if ($self->config->avoid_crossing_perimeters) {
         $self->layer_mp(Slic3r::GCode::MotionPlanner->new(
@@ -171,6 +183,15 @@ sub extrude {
         : $self->extrude_path(@_);
 }
 
+# returns the supplied points not lying on any overhang of the current layer
+sub _non_overhang_points {
+    my ($self, @points) = @_;
+    
+    my $overhangs = $self->_layer_overhangs_index or return @points;
+    my $contained = $overhangs->contains_points(\@points);
+    return @points[ grep !$contained->[$_], 0..$#points ];
+}
+
 sub extrude_loop {
     my ($self, $loop, $description) = @_;
     
@@ -186,7 +207,7 @@ sub extrude_loop {
     }
     my @candidates = ();
     if ($Slic3r::Config->start_perimeters_at_non_overhang) {
-        @candidates = grep !$self->_layer_overhangs->contains_point($_), @concave;
+        @candidates = $self->_non_overhang_points(@concave);
     }
     if (!@candidates) {
         # if none, look for any concave vertex
@@ -194,7 +215,7 @@ sub extrude_loop {
         if (!@candidates) {
             # if none, look for any non-overhang vertex
             if ($Slic3r::Config->start_perimeters_at_non_overhang) {
-                @candidates = grep !$self->_layer_overhangs->contains_point($_), @$polygon;
+                @candidates = $self->_non_overhang_points(@$polygon);
             }
             if (!@candidates) {
                 # if none, all points are valid candidates
@@ -401,9 +422,9 @@ sub travel_to {
     # *and* in an island in the upper layer (so that the ooze will not be visible)
     if ($travel->length < scale $self->extruder->retract_before_travel
         || ($self->config->only_retract_when_crossing_perimeters
-            && (first { $_->contains_line($travel) } @{$self->_upper_layer_islands})
-            && (first { $_->contains_line($travel) } @{$self->_layer_islands}))
-        || (defined $role && $role == EXTR_ROLE_SUPPORTMATERIAL && (first { $_->contains_line($travel) } @{$self->layer->support_islands}))
+            && $self->_upper_layer_islands->contains_line($travel)
+            && $self->_layer_islands->contains_line($travel))
+        || (defined $role && $role == EXTR_ROLE_SUPPORTMATERIAL && $self->_support_islands && $self->_support_islands->contains_line($travel))
         ) {
         $self->straight_once(0);
         $self->speed('travel');
@@ -443,14 +464,8 @@ sub _plan {
     # if the path is not contained in a single island we need to retract
     my $need_retract = !$self->config->only_retract_when_crossing_perimeters;
     if (!$need_retract) {
-        $need_retract = 1;
-        foreach my $island (@{$self->_upper_layer_islands}) {
-            # discard the island if at any line is not enclosed in it
-            next if first { !$island->contains_line($_) } @travel;
-            # okay, this island encloses the full travel path
-            $need_retract = 0;
-            last;
-        }
+        # no need to retract if a single island encloses the full travel path
+        $need_retract = !$self->_upper_layer_islands->contains_all_lines(\@travel);
     }
     
     # do the retract (the travel_to argument is broken)
@@ -45,6 +45,9 @@ sub process_layer {
     my ($layer, $object_copies) = @_;
     my $gcode = "";
     
+    Slic3r::Geometry::Clipper::offset_cache_clear();  # cached offsets are scoped to a layer
+    Slic3r::Fill::cache_clear();
+    
     # check whether we're going to apply spiralvase logic
     my $spiralvase = defined $self->spiralvase
         && ($layer->id > 0 || $Slic3r::Config->brim_width == 0)
@@ -100,6 +103,9 @@ sub process_layer {
         $self->gcodegen->straight_once(1);
     }
     
+    # index of the layer islands, built on first use and shared by all copies
+    my $slices_index;
+    
     for my $copy (@$object_copies) {
         $self->gcodegen->new_object(1) if ($self->_last_obj_copy // '') ne "$copy";
         $self->_last_obj_copy("$copy");
@@ -112,12 +118,12 @@ sub process_layer {
             if ($layer->support_interface_fills->count > 0) {
                 $gcode .= $self->gcodegen->set_extruder($self->extruders->[$Slic3r::Config->support_material_interface_extruder-1]);
                 $gcode .= $self->gcodegen->extrude_path($_, 'support material interface') 
-                    for @{$layer->support_interface_fills->chained_path_from($self->gcodegen->last_pos, 0)}; 
+                    for @{$layer->support_interface_fills->chained_path_from($self->gcodegen->last_pos, 0, 1)}; 
             }
             if ($layer->support_fills->count > 0) {
                 $gcode .= $self->gcodegen->set_extruder($self->extruders->[$Slic3r::Config->support_material_extruder-1]);
                 $gcode .= $self->gcodegen->extrude_path($_, 'support material') 
-                    for @{$layer->support_fills->chained_path_from($self->gcodegen->last_pos, 0)};
+                    for @{$layer->support_fills->chained_path_from($self->gcodegen->last_pos, 0, 1)};
             }
         }
         
@@ -137,24 +143,14 @@ sub process_layer {
             if ($Slic3r::Config->avoid_crossing_perimeters) {
                 push @islands, { perimeters => [], fills => [] }
                     for 1 .. (@{$layer->slices} || 1);  # make sure we have at least one island hash to avoid failure of the -1 subscript below
-                PERIMETER: foreach my $perimeter (@{$layerm->perimeters}) {
-                    for my $i (0 .. $#{$layer->slices}-1) {
-                        if ($layer->slices->[$i]->contour->contains_point($perimeter->first_point)) {
-                            push @{ $islands[$i]{perimeters} }, $perimeter;
-                            next PERIMETER;
-                        }
-                    }
-                    push @{ $islands[-1]{perimeters} }, $perimeter; # optimization
-                }
-                FILL: foreach my $fill (@{$layerm->fills}) {
-                    for my $i (0 .. $#{$layer->slices}-1) {
-                        if ($layer->slices->[$i]->contour->contains_point($fill->first_point)) {
-                            push @{ $islands[$i]{fills} }, $fill;
-                            next FILL;
-                        }
-                    }
-                    push @{ $islands[-1]{fills} }, $fill; # optimization
-                }
+                
+                # find_point() returns -1 when no island contains the point,
+                # so such entities go to the last island
+                $slices_index //= Slic3r::ExPolygon::Collection::Index->new(@{$layer->slices});
+                push @{ $islands[ $slices_index->find_point($_->first_point, 1) ]{perimeters} }, $_
+                    for @{$layerm->perimeters};
+                push @{ $islands[ $slices_index->find_point($_->first_point, 1) ]{fills} }, $_
+                    for @{$layerm->fills};
             } else {
                 push @islands, {
                     perimeters  => $layerm->perimeters,
@@ -215,7 +211,7 @@ sub _extrude_infill {
     for my $fill (@{ $island->{fills} }) {
         if ($fill->isa('Slic3r::ExtrusionPath::Collection')) {
             $gcode .= $self->gcodegen->extrude($_, 'fill') 
-                for @{$fill->chained_path_from($self->gcodegen->last_pos, 0)};
+                for @{$fill->chained_path_from($self->gcodegen->last_pos, 0, 1)};
         } else {
             $gcode .= $self->gcodegen->extrude($fill, 'fill') ;
         }
@@ -419,7 +419,7 @@ sub build {
         },
         {
             title => 'Speed for non-print moves',
-            options => [qw(travel_speed)],
+            options => [qw(travel_speed travel_optimization)],
         },
         {
             title => 'Modifiers',
@@ -20,7 +20,8 @@ our @EXPORT_OK = qw(
     rad2deg_dir bounding_box_center line_intersects_any douglas_peucker
     polyline_remove_short_segments normal triangle_normal polygon_is_convex
     scaled_epsilon bounding_box_3D size_3D size_2D
-    convex_hull
+    convex_hull polygons_area filter_by_min_area
+    douglas_peucker_polygons douglas_peucker_polylines
 );
 
 
@@ -106,68 +107,6 @@ sub points_coincide {
     return 0;
 }
 
-sub distance_between_points {
-    my ($p1, $p2) = @_;
-    return sqrt((($p1->[X] - $p2->[X])**2) + ($p1->[Y] - $p2->[Y])**2);
-}
-
-# this will check whether a point is in a polygon regardless of polygon orientation
-sub point_in_polygon {
-    my ($point, $polygon) = @_;
-    
-    my ($x, $y) = @$point;
-    my $n = @$polygon;
-    my @x = map $_->[X], @$polygon;
-    my @y = map $_->[Y], @$polygon;
-    
-    # Derived from the comp.graphics.algorithms FAQ,
-    # courtesy of Wm. Randolph Franklin
-    my ($i, $j);
-    my $side = 0;                           # 0 = outside; 1 = inside
-    for ($i = 0, $j = $n - 1; $i < $n; $j = $i++) {
-        if (
-            # If the y is between the (y-) borders...
-            ($y[$i] <= $y && $y < $y[$j]) || ($y[$j] <= $y && $y < $y[$i])
-            and
-            # ...the (x,y) to infinity line crosses the edge
-            # from the ith point to the jth point...
-            ($x < ($x[$j] - $x[$i]) * ($y - $y[$i]) / ($y[$j] - $y[$i]) + $x[$i])
-        ) {
-            $side = not $side;  # Jump the fence
-        }
-    }
-    
-    # if point is not in polygon, let's check whether it belongs to the contour
-    if (!$side && 0) {
-        return 1 if polygon_segment_having_point($polygon, $point);
-    }
-    
-    return $side;
-}
-
-sub point_in_segment {
-    my ($point, $line) = @_;
-    
-    my ($x, $y) = @$point;
-    my $line_p = $line->pp;
-    my @line_x = sort { $a <=> $b } $line_p->[A][X], $line_p->[B][X];
-    my @line_y = sort { $a <=> $b } $line_p->[A][Y], $line_p->[B][Y];
-    
-    # check whether the point is in the segment bounding box
-    return 0 unless $x >= ($line_x[0] - epsilon) && $x <= ($line_x[1] + epsilon)
-        && $y >= ($line_y[0] - epsilon) && $y <= ($line_y[1] + epsilon);
-    
-    # if line is vertical, check whether point's X is the same as the line
-    if ($line_p->[A][X] == $line_p->[B][X]) {
-        return abs($x - $line_p->[A][X]) < epsilon ? 1 : 0;
-    }
-    
-    # calculate the Y in line at X of the point
-    my $y3 = $line_p->[A][Y] + ($line_p->[B][Y] - $line_p->[A][Y])
-        * ($x - $line_p->[A][X]) / ($line_p->[B][X] - $line_p->[A][X]);
-    return abs($y3 - $y) < epsilon ? 1 : 0;
-}
-
 sub segment_in_segment {
     my ($needle, $haystack) = @_;
     
@@ -175,43 +114,6 @@ sub segment_in_segment {
     return point_in_segment($needle->[A], $haystack) && point_in_segment($needle->[B], $haystack);
 }
 
-sub polyline_lines {
-    my ($polyline) = @_;
-    my @points = @$polyline;
-    return map Slic3r::Line->new(@points[$_, $_+1]), 0 .. $#points-1;
-}
-
-sub polygon_lines {
-    my ($polygon) = @_;
-    return polyline_lines([ @$polygon, $polygon->[0] ]);
-}
-
-# given a segment $p1-$p2, get the point at $distance from $p1 along segment
-sub point_along_segment {
-    my ($p1, $p2, $distance) = @_;
-    
-    my $point = [ @$p1 ];
-    
-    my $line_length = sqrt( (($p2->[X] - $p1->[X])**2) + (($p2->[Y] - $p1->[Y])**2) );
-    for (X, Y) {
-        if ($p1->[$_] != $p2->[$_]) {
-            $point->[$_] = $p1->[$_] + ($p2->[$_] - $p1->[$_]) * $distance / $line_length;
-        }
-    }
-    
-    return Slic3r::Point->new(@$point);
-}
-
-# given a $polygon, return the (first) segment having $point
-sub polygon_segment_having_point {
-    my ($polygon, $point) = @_;
-    
-    foreach my $line (@{ $polygon->lines }) {
-        return $line if point_in_segment($point, $line);
-    }
-    return undef;
-}
-
 # return true if the given segment is contained in any edge of the polygon
 sub polygon_has_subsegment {
     my ($polygon, $segment) = @_;
@@ -231,16 +133,6 @@ sub polygon_is_convex {
     return 1;
 }
 
-sub deg2rad {
-    my ($degrees) = @_;
-    return PI() * $degrees / 180;
-}
-
-sub rad2deg {
-    my ($rad) = @_;
-    return $rad / PI() * 180;
-}
-
 sub rad2deg_dir {
     my ($rad) = @_;
     $rad = ($rad < PI) ? (-$rad + PI/2) : ($rad + PI/2);
@@ -248,25 +140,6 @@ sub rad2deg_dir {
     return rad2deg($rad);
 }
 
-sub rotate_points {
-    my ($radians, $center, @points) = @_;
-    $center //= [0,0];
-    return map {
-        [
-            $center->[X] + cos($radians) * ($_->[X] - $center->[X]) - sin($radians) * ($_->[Y] - $center->[Y]),
-            $center->[Y] + cos($radians) * ($_->[Y] - $center->[Y]) + sin($radians) * ($_->[X] - $center->[X]),
-        ]
-    } @points;
-}
-
-sub move_points {
-    my ($shift, @points) = @_;
-    return map {
-        my @p = @$_;
-        Slic3r::Point->new($shift->[X] + $p[X], $shift->[Y] + $p[Y]);
-    } @points;
-}
-
 sub move_points_3D {
     my ($shift, @points) = @_;
     return map [
@@ -336,16 +209,6 @@ sub line_intersects_any {
     return 0;
 }
 
-sub line_intersection {
-    my ($line1, $line2, $require_crossing) = @_;
-    $require_crossing ||= 0;
-    
-    my $intersection = _line_intersection(map @$_, @$line1, @$line2);
-    return (ref $intersection && $intersection->[1] == $require_crossing) 
-        ? $intersection->[0] 
-        : undef;
-}
-
 sub collinear {
     my ($line1, $line2, $require_overlapping) = @_;
     my $intersection = _line_intersection(map @$_, @$line1, @$line2);
@@ -362,77 +225,6 @@ sub collinear {
     return 1;
 }
 
-sub _line_intersection {
-  my ( $x0, $y0, $x1, $y1, $x2, $y2, $x3, $y3 ) = @_;
-
-  my ($x, $y);  # The as-yet-undetermined intersection point.
-
-  my $dy10 = $y1 - $y0; # dyPQ, dxPQ are the coordinate differences
-  my $dx10 = $x1 - $x0; # between the points P and Q.
-  my $dy32 = $y3 - $y2;
-  my $dx32 = $x3 - $x2;
-
-  my $dy10z = abs( $dy10 ) < epsilon; # Is the difference $dy10 "zero"?
-  my $dx10z = abs( $dx10 ) < epsilon;
-  my $dy32z = abs( $dy32 ) < epsilon;
-  my $dx32z = abs( $dx32 ) < epsilon;
-
-  my $dyx10;                            # The slopes.
-  my $dyx32;
-  
-  $dyx10 = $dy10 / $dx10 unless $dx10z;
-  $dyx32 = $dy32 / $dx32 unless $dx32z;
-
-  # Now we know all differences and the slopes;
-  # we can detect horizontal/vertical special cases.
-  # E.g., slope = 0 means a horizontal line.
-
-  unless ( defined $dyx10 or defined $dyx32 ) {
-    return "parallel vertical";
-  }
-  elsif ( $dy10z and not $dy32z ) { # First line horizontal.
-    $y = $y0;
-    $x = $x2 + ( $y - $y2 ) * $dx32 / $dy32;
-  }
-  elsif ( not $dy10z and $dy32z ) { # Second line horizontal.
-    $y = $y2;
-    $x = $x0 + ( $y - $y0 ) * $dx10 / $dy10;
-  }
-  elsif ( $dx10z and not $dx32z ) { # First line vertical.
-    $x = $x0;
-    $y = $y2 + $dyx32 * ( $x - $x2 );
-  }
-  elsif ( not $dx10z and $dx32z ) { # Second line vertical.
-    $x = $x2;
-    $y = $y0 + $dyx10 * ( $x - $x0 );
-  }
-  elsif ( abs( $dyx10 - $dyx32 ) < epsilon ) {
-    # The slopes are suspiciously close to each other.
-    # Either we have parallel collinear or just parallel lines.
-
-    # The bounding box checks have already weeded the cases
-    # "parallel horizontal" and "parallel vertical" away.
-
-    my $ya = $y0 - $dyx10 * $x0;
-    my $yb = $y2 - $dyx32 * $x2;
-    
-    return "parallel collinear" if abs( $ya - $yb ) < epsilon;
-    return "parallel";
-  }
-  else {
-    # None of the special cases matched.
-    # We have a "honest" line intersection.
-
-    $x = ($y2 - $y0 + $dyx10*$x0 - $dyx32*$x2)/($dyx10 - $dyx32);
-    $y = $y0 + $dyx10 * ($x - $x0);
-  }
-
-  my $h10 = $dx10 ? ($x - $x0) / $dx10 : ($dy10 ? ($y - $y0) / $dy10 : 1);
-  my $h32 = $dx32 ? ($x - $x2) / $dx32 : ($dy32 ? ($y - $y2) / $dy32 : 1);
-
-  return [Slic3r::Point->new($x, $y), $h10 >= 0 && $h10 <= 1 && $h32 >= 0 && $h32 <= 1];
-}
-
 # http://paulbourke.net/geometry/lineline2d/
 sub _line_intersection2 {
     my ($line1, $line2) = @_;
@@ -565,32 +357,6 @@ sub polyline_remove_short_segments {
     }
 }
 
-sub douglas_peucker {
-    my ($points, $tolerance) = @_;
-    no warnings "recursion";
-    
-    my $results = [];
-    my $dmax = 0;
-    my $index = 0;
-    for my $i (1..$#$points) {
-        my $d = $points->[$i]->distance_to(Slic3r::Line->new($points->[0], $points->[-1]));
-        if ($d > $dmax) {
-            $index = $i;
-            $dmax = $d;
-        }
-    }
-    if ($dmax >= $tolerance) {
-        my $dp1 = douglas_peucker([ @$points[0..$index] ], $tolerance);
-        $results = [
-            @$dp1[0..($#$dp1-1)],
-            @{douglas_peucker([ @$points[$index..$#$points] ], $tolerance)},
-        ];
-    } else {
-        $results = [ $points->[0], $points->[-1] ];
-    }
-    return $results;
-}
-
 sub douglas_peucker2 {
     my ($points, $tolerance) = @_;
     
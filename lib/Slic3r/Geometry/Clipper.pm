@@ -8,6 +8,7 @@ our @EXPORT_OK = qw(offset offset_ex
     diff_ex diff union_ex intersection_ex xor_ex JT_ROUND JT_MITER
     JT_SQUARE is_counter_clockwise union_pt offset2 offset2_ex
     intersection intersection_pl diff_pl union CLIPPER_OFFSET_SCALE
-    union_pt_chained);
+    union_pt_chained union_parallel union_parallel_ex union_parallel_expolygons
+    offset_cache_enable offset_cache_clear offset_cache_stats);
 
 1;
@@ -3,7 +3,7 @@ use Moo;
 
 use List::Util qw(first);
 use Slic3r::Geometry qw(scale);
-use Slic3r::Geometry::Clipper qw(union_ex);
+use Slic3r::Geometry::Clipper qw(union_parallel_expolygons);
 
 has 'id'                => (is => 'rw', required => 1, trigger => 1); # sequential number of layer, 0-based
 has 'object'            => (is => 'ro', weak_ref => 1, required => 1, handles => [qw(print config)]);
@@ -48,7 +48,9 @@ sub region {
 sub make_slices {
     my $self = shift;
     
-    my $slices = union_ex([ map $_->p, map @{$_->slices}, @{$self->regions} ]);
+    # whole expolygons keep their holes in the same group of the parallel union
+    my $slices = union_parallel_expolygons([ map $_->expolygon, map @{$_->slices}, @{$self->regions} ],
+        0, $Slic3r::Config->threads);
     $self->slices->clear;
     $self->slices->append(@$slices);
 }
@@ -56,6 +58,8 @@ sub make_slices {
 sub make_perimeters {
     my $self = shift;
     Slic3r::debugf "Making perimeters for layer %d\n", $self->id;
+    Slic3r::Geometry::Clipper::offset_cache_clear();  # cached offsets are scoped to a layer
+    Slic3r::Fill::cache_clear();
     $_->make_perimeters for @{$self->regions};
 }
 
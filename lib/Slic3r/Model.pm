@@ -198,7 +198,7 @@ sub has_objects_with_no_instances {
 # this returns the bounding box of the *transformed* instances
 sub bounding_box {
     my $self = shift;
-    return Slic3r::Geometry::BoundingBox->merge(map $_->bounding_box, @{ $self->objects });
+    return Slic3r::Geometry::BoundingBox3->new_from_bounding_boxes(map $_->bounding_box, @{ $self->objects });
 }
 
 sub align_to_origin {
@@ -208,7 +208,7 @@ sub align_to_origin {
     # have lowest value for each axis at coordinate 0
     {
         my $bb = $self->bounding_box;
-        $self->translate(map -$bb->extents->[$_][MIN], X,Y,Z);
+        $self->translate(@{$bb->vector_to_origin});
     }
     
     # align all instances to 0,0 as well
@@ -305,7 +305,7 @@ use Moo;
 
 use File::Basename qw(basename);
 use List::Util qw(first sum);
-use Slic3r::Geometry qw(X Y Z MIN MAX);
+use Slic3r::Geometry qw(X Y Z);
 
 has 'input_file'            => (is => 'rw');
 has 'model'                 => (is => 'ro', weak_ref => 1, required => 1);
@@ -403,7 +403,7 @@ sub align_to_origin {
     # calculate the displacements needed to 
     # have lowest value for each axis at coordinate 0
     my $bb = $self->bounding_box;
-    my @shift = map -$bb->extents->[$_][MIN], X,Y,Z;
+    my @shift = @{$bb->vector_to_origin};
     $self->translate(@shift);
     return @shift;
 }
@@ -2,7 +2,7 @@ package Slic3r::Polyline;
 use strict;
 use warnings;
 
-use Slic3r::Geometry qw(A B X Y X1 X2 Y1 Y2);
+use Slic3r::Geometry qw(A B X Y);
 use Slic3r::Geometry::Clipper qw(JT_SQUARE);
 use Storable qw();
 
@@ -17,14 +17,9 @@ sub wkt {
     return sprintf "LINESTRING((%s))", join ',', map "$_->[0] $_->[1]", @$self;
 }
 
-sub bounding_box {
-    my $self = shift;
-    return Slic3r::Geometry::BoundingBox->new_from_points($self);
-}
-
 sub size {
     my $self = shift;
-    return [ Slic3r::Geometry::size_2D($self) ];
+    return $self->bounding_box->size;
 }
 
 sub align_to_origin {
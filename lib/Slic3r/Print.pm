@@ -5,7 +5,7 @@ use File::Basename qw(basename fileparse);
 use File::Spec;
 use List::Util qw(min max first);
 use Slic3r::ExtrusionPath ':roles';
-use Slic3r::Geometry qw(X Y Z X1 Y1 X2 Y2 MIN MAX PI scale unscale move_points chained_path
+use Slic3r::Geometry qw(X Y Z X1 Y1 X2 Y2 PI scale unscale chained_path
     convex_hull);
 use Slic3r::Geometry::Clipper qw(diff_ex union_ex union_pt intersection_ex intersection offset
     offset2 union_pt_chained JT_ROUND JT_SQUARE);
@@ -107,7 +107,7 @@ sub add_model_object {
     }
     
     # bounding box of the original meshes in original position in unscaled coordinates
-    my $bb1 = Slic3r::Geometry::BoundingBox->merge(map $_->bounding_box, values %meshes);
+    my $bb1 = Slic3r::Geometry::BoundingBox3->new_from_bounding_boxes(map $_->bounding_box, values %meshes);
     
     foreach my $mesh (values %meshes) {
         # we ignore the per-instance transformations currently and only 
@@ -117,7 +117,7 @@ sub add_model_object {
     
     # we align object also after transformations so that we only work with positive coordinates
     # and the assumption that bounding_box === size works
-    my $bb2 = Slic3r::Geometry::BoundingBox->merge(map $_->bounding_box, values %meshes);
+    my $bb2 = Slic3r::Geometry::BoundingBox3->new_from_bounding_boxes(map $_->bounding_box, values %meshes);
     $_->translate(@{$bb2->vector_to_origin}) for values %meshes;
     
     # prepare scaled object size
@@ -129,8 +129,8 @@ sub add_model_object {
     my @copies = ();
     foreach my $instance (@{ $object->instances }) {
         push @copies, Slic3r::Point->new(
-            scale($instance->offset->[X] - $bb1->extents->[X][MIN]),
-            scale($instance->offset->[Y] - $bb1->extents->[Y][MIN]),
+            scale($instance->offset->[X] - $bb1->x_min),
+            scale($instance->offset->[Y] - $bb1->y_min),
         );
     }
     
@@ -305,8 +305,8 @@ sub _simplify_slices {
     my ($distance) = @_;
     
     foreach my $layer (map @{$_->layers}, @{$self->objects}) {
-        $layer->slices->simplify($distance);
-        $_->slices->simplify($distance) for @{$layer->regions};
+        $layer->slices->simplify($distance, $Slic3r::Config->threads);
+        $_->slices->simplify($distance, $Slic3r::Config->threads) for @{$layer->regions};
     }
 }
 
@@ -318,6 +318,9 @@ sub export_gcode {
     my $status_cb = $params{status_cb} || sub {};
     my $t0 = [gettimeofday];
     
+    # each thread will memoize the offsets of the layer it's processing
+    Slic3r::Geometry::Clipper::offset_cache_enable(&Slic3r::OFFSET_CACHE_SIZE);
+    
     # skein the STL into layers
     # each layer has surfaces with holes
     $status_cb->(10, "Processing triangulated mesh");
@@ -330,6 +333,10 @@ sub export_gcode {
     die "No layers were detected. You might want to repair your STL file(s) or check their size and retry.\n"
         if !@{$self->objects};
     
+    # travel orderings get their moves shortened within a budget proportional
+    # to their size, for the rest of this export only
+    Slic3r::Geometry::travel_refinement_enable($self->config->travel_optimization);
+    
     if ($Slic3r::Config->resolution) {
         $status_cb->(15, "Simplifying input");
         $self->_simplify_slices(scale $Slic3r::Config->resolution);
@@ -449,6 +456,12 @@ sub export_gcode {
         }
     }
     
+    {
+        my $stats = Slic3r::Fill::cache_stats();
+        Slic3r::debugf "Infill cache: %d hits, %d misses; honeycomb pattern cache: %d hits, %d misses\n",
+            @$stats{qw(hits misses pattern_hits pattern_misses)};
+    }
+    
     # output some statistics
     unless ($params{quiet}) {
         $self->processing_time(tv_interval($t0));
@@ -460,7 +473,17 @@ sub export_gcode {
         print map sprintf("Filament required: %.1fmm (%.1fcm3)\n",
             $_->absolute_E, $_->extruded_volume/1000),
             @{$self->extruders};
+        printf "Travel saved by path reordering: %.1fmm\n",
+            unscale(Slic3r::Geometry::travel_refinement_saved());
+        my $stats = Slic3r::Geometry::Clipper::offset_cache_stats();
+        printf "Offset cache: %d hits, %d misses (%.1f%% hit rate)\n",
+            $stats->{hits}, $stats->{misses},
+            100 * $stats->{hits} / (($stats->{hits} + $stats->{misses}) || 1);
     }
+    
+    # don't let later exports or previews inherit the budget or the cached offsets
+    Slic3r::Geometry::travel_refinement_enable(0);
+    Slic3r::Geometry::Clipper::offset_cache_enable(0);
 }
 
 sub export_svg {
@@ -510,10 +533,14 @@ EOF
             
             # sort slices so that the outermost ones come first
             my @slices = sort { $a->contour->contains_point($b->contour->first_point) ? 0 : 1 } @{$layer->slices};
+            
+            # move all the slices at once from a copy to the next one
+            my $set = Slic3r::Geometry::PolygonSet->new(@slices);
+            my @shift = (0,0);
             foreach my $copy (@{$self->objects->[$obj_idx]->copies}) {
-                foreach my $slice (@slices) {
-                    my $expolygon = $slice->clone;
-                    $expolygon->translate(@$copy);
+                $set->translate($copy->[X] - $shift[X], $copy->[Y] - $shift[Y]);
+                @shift = @$copy;
+                foreach my $expolygon (@{$set->expolygons}) {
                     $print_polygon->($expolygon->contour, 'contour');
                     $print_polygon->($_, 'hole') for @{$expolygon->holes};
                     push @current_layer_slices, $expolygon;
@@ -558,26 +585,24 @@ sub make_skirt {
     return unless $Slic3r::Config->skirts > 0
         || ($Slic3r::Config->ooze_prevention && @{$self->extruders} > 1);
     
-    # collect points from all layers contained in skirt height
-    my @points = ();
+    # compute the convex hull of all layers contained in skirt height: each object
+    # is reduced to its own hull layer by layer, which is then placed at each copy
+    my $hull = Slic3r::Geometry::ConvexHull->new;
     foreach my $obj_idx (0 .. $#{$self->objects}) {
         my $object = $self->objects->[$obj_idx];
+        my $object_hull = Slic3r::Geometry::ConvexHull->new;
         my @layers = map $object->layers->[$_], 0..min($Slic3r::Config->skirt_height-1, $#{$object->layers});
-        my @layer_points = (
-            (map @$_, map @$_, map @{$_->slices}, @layers),
-        );
+        $object_hull->append_expolygons($_->slices) for @layers;
         if (@{ $object->support_layers }) {
             my @support_layers = map $object->support_layers->[$_], 0..min($Slic3r::Config->skirt_height-1, $#{$object->support_layers});
-            push @layer_points,
-                (map @{$_->polyline}, map @{$_->support_fills}, grep $_->support_fills, @support_layers),
-                (map @{$_->polyline}, map @{$_->support_interface_fills}, grep $_->support_interface_fills, @support_layers);
+            $object_hull->append_extrusions($_) for
+                (map $_->support_fills, grep $_->support_fills, @support_layers),
+                (map $_->support_interface_fills, grep $_->support_interface_fills, @support_layers);
         }
-        push @points, map move_points($_, @layer_points), @{$object->copies};
+        $hull->append_hull($object_hull, $_) for @{$object->copies};
     }
-    return if @points < 3;  # at least three points required for a convex hull
-    
-    # find out convex hull
-    my $convex_hull = convex_hull(\@points);
+    return if $hull->count < 3;  # at least three points required for a convex hull
+    my $convex_hull = $hull->polygon;
     
     my @extruded_length = ();  # for each extruder
     
@@ -764,16 +789,18 @@ sub write_gcode {
         # compute the offsetted convex hull for each object and repeat it for each copy.
         my @islands = ();
         foreach my $obj_idx (0 .. $#{$self->objects}) {
-            my $convex_hull = convex_hull([
-                map @{$_->contour}, map @{$_->slices}, @{$self->objects->[$obj_idx]->layers},
-            ]);
+            my $convex_hull = Slic3r::Geometry::ConvexHull->new;
+            $convex_hull->append_expolygons($_->slices) for @{$self->objects->[$obj_idx]->layers};
             # discard layers only containing thin walls (offset would fail on an empty polygon)
-            if (@$convex_hull) {
-                my $expolygon = Slic3r::ExPolygon->new($convex_hull);
+            if ($convex_hull->count >= 3) {
+                my $expolygon = Slic3r::ExPolygon->new($convex_hull->polygon);
                 $expolygon->translate(scale $shift[X], scale $shift[Y]);
-                my @island = @{$expolygon->offset_ex(scale $distance_from_objects, 1, JT_SQUARE)};
+                my $set = Slic3r::Geometry::PolygonSet->new(@{$expolygon->offset_ex(scale $distance_from_objects, 1, JT_SQUARE)});
+                my @shift = (0,0);
                 foreach my $copy (@{ $self->objects->[$obj_idx]->copies }) {
-                    push @islands, map { my $c = $_->clone; $c->translate(@$copy); $c } @island;
+                    $set->translate($copy->[X] - $shift[X], $copy->[Y] - $shift[Y]);
+                    @shift = @$copy;
+                    push @islands, @{$set->expolygons};
                 }
             }
         }
@@ -4,7 +4,7 @@ use Moo;
 use List::Util qw(sum min max);
 use Slic3r::ExtrusionPath ':roles';
 use Slic3r::Geometry qw(scale scaled_epsilon PI rad2deg deg2rad);
-use Slic3r::Geometry::Clipper qw(offset diff union union_ex intersection offset_ex offset2
+use Slic3r::Geometry::Clipper qw(offset diff union union_ex union_parallel_expolygons intersection offset_ex offset2
     intersection_pl);
 use Slic3r::Surface ':types';
 
@@ -362,9 +362,10 @@ sub clip_with_object {
         my @layers = grep { $_->print_z > $zmin && ($_->print_z - $_->height) < $zmax }
             @{$object->layers};
         
+        my $slices = union_parallel_expolygons([ map @{$_->slices}, @layers ], 0, $Slic3r::Config->threads);
         $support->{$i} = diff(
             $support->{$i},
-            offset([ map @$_, map @{$_->slices}, @layers ], +$self->flow->scaled_width),
+            offset([ map @$_, @$slices ], +$self->flow->scaled_width),
         );
     }
 }
@@ -329,6 +329,9 @@ $j
    Quality options (slower slicing):
     --extra-perimeters  Add more perimeters when needed (default: yes)
     --avoid-crossing-perimeters Optimize travel moves so that no perimeters are crossed (default: no)
+    --travel-optimization
+                        Number of moves tried per path to shorten travel between paths after
+                        the nearest-neighbor ordering (0 to disable, default: $config->{travel_optimization})
     --start-perimeters-at-concave-points
                         Try to start perimeters at concave points if any (default: no)
     --start-perimeters-at-non-overhang
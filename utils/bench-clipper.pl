@@ -0,0 +1,67 @@
+#!/usr/bin/perl
+# This script times many small boolean operations, like the per-surface
+# ones performed when filling layers, to measure the Clipper engine overhead
+
+use strict;
+use warnings;
+
+BEGIN {
+    use FindBin;
+    use lib "$FindBin::Bin/../lib";
+}
+
+use Getopt::Long qw(:config no_auto_abbrev);
+use Time::HiRes qw(gettimeofday tv_interval);
+use Slic3r;
+use Slic3r::Geometry::Clipper qw(diff intersection union_ex);
+$|++;
+
+my %opt = (
+    count => 100000,
+);
+{
+    my %options = (
+        'help'                  => sub { usage() },
+        'count=i'               => \$opt{count},
+    );
+    GetOptions(%options) or usage(1);
+}
+
+# overlapping pairs of small squares, rotated so that edges aren't aligned
+my @pairs = ();
+for my $i (0..999) {
+    my $square = Slic3r::Polygon->new([0,0], [1000000,0], [1000000,1000000], [0,1000000]);
+    $square->rotate($i / 1000, Slic3r::Point->new(0,0));
+    my $other = $square->clone;
+    $other->translate(300000 + $i * 100, 200000);
+    push @pairs, [ [$square], [$other] ];
+}
+
+my @ops = (
+    [ 'diff',          sub { diff(@{$_[0]}) } ],
+    [ 'intersection',  sub { intersection(@{$_[0]}) } ],
+    [ 'union_ex',      sub { union_ex([ map @$_, @{$_[0]} ]) } ],
+);
+
+foreach my $op (@ops) {
+    my ($name, $cb) = @$op;
+    my $t0 = [gettimeofday];
+    $cb->($pairs[$_ % @pairs]) for 1..$opt{count};
+    my $elapsed = tv_interval($t0);
+    printf "%-14s %d ops in %.3f s (%.1f us/op)\n", $name, $opt{count}, $elapsed,
+        1000000 * $elapsed / $opt{count};
+}
+
+
+sub usage {
+    my ($exit_code) = @_;
+
+    print <<"EOF";
+Usage: bench-clipper.pl [ --count N ]
+
+    --count N       Number of operations of each kind (default: $opt{count})
+EOF
+    exit ($exit_code || 0);
+}
+
+__END__
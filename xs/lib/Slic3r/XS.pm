@@ -192,4 +192,46 @@ use overload
     '@{}' => sub { $_[0]->arrayref },
     'fallback' => 1;
 
+package Slic3r::Layer::PerimeterGenerator;
+
+sub new {
+    my ($class, %args) = @_;
+    
+    return $class->_new(
+        $args{slices},                  # required
+        $args{perimeter_width},         # required
+        $args{perimeter_spacing},       # required
+        $args{solid_infill_spacing},    # required
+        $args{flow_spacing},            # required
+        $args{perimeters},              # required
+        $args{thin_walls}               // 0,
+        $args{gap_fill}                 // 0,
+        $args{outer_first}              // 0,
+    );
+}
+
+package Slic3r::GCode::MotionPlanner;
+
+sub new {
+    my ($class, %args) = @_;
+    
+    return $class->_new(
+        $args{islands},             # required
+        $args{no_internal}  // 0,
+    );
+}
+
+package Slic3r::BridgeDetector;
+
+sub new {
+    my ($class, %args) = @_;
+    
+    return $class->_new(
+        $args{expolygon},           # required
+        $args{lower_slices},        # required
+        $args{extrusion_width},     # required
+        $args{line_spacing}         // $args{extrusion_width},
+    );
+}
+
 1;
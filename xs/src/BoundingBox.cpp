@@ -0,0 +1,199 @@
+#include "BoundingBox.hpp"
+#include "Polygon.hpp"
+#include <algorithm>
+
+namespace Slic3r {
+
+BoundingBox::BoundingBox(const Points &points)
+    : defined(false)
+{
+    this->merge(points);
+}
+
+void
+BoundingBox::merge(const Point &point)
+{
+    if (this->defined) {
+        this->min.x = std::min(point.x, this->min.x);
+        this->min.y = std::min(point.y, this->min.y);
+        this->max.x = std::max(point.x, this->max.x);
+        this->max.y = std::max(point.y, this->max.y);
+    } else {
+        this->min = this->max = point;
+        this->defined = true;
+    }
+}
+
+void
+BoundingBox::merge(const Points &points)
+{
+    for (Points::const_iterator it = points.begin(); it != points.end(); ++it)
+        this->merge(*it);
+}
+
+void
+BoundingBox::merge(const BoundingBox &bb)
+{
+    if (!bb.defined) return;
+    this->merge(bb.min);
+    this->merge(bb.max);
+}
+
+void
+BoundingBox::scale(double factor)
+{
+    this->min.scale(factor);
+    this->max.scale(factor);
+}
+
+void
+BoundingBox::translate(double x, double y)
+{
+    this->min.translate(x, y);
+    this->max.translate(x, y);
+}
+
+/* grows the box by delta on each side (shrinks it if negative) */
+void
+BoundingBox::offset(double delta)
+{
+    this->min.translate(-delta, -delta);
+    this->max.translate(delta, delta);
+}
+
+/* counter-clockwise, starting from min */
+void
+BoundingBox::polygon(Polygon* polygon) const
+{
+    polygon->points.clear();
+    polygon->points.reserve(4);
+    polygon->points.push_back(this->min);
+    polygon->points.push_back(Point(this->max.x, this->min.y));
+    polygon->points.push_back(this->max);
+    polygon->points.push_back(Point(this->min.x, this->max.y));
+}
+
+Point
+BoundingBox::size() const
+{
+    return Point(this->max.x - this->min.x, this->max.y - this->min.y);
+}
+
+Point
+BoundingBox::center() const
+{
+    return Point((this->min.x + this->max.x) / 2, (this->min.y + this->max.y) / 2);
+}
+
+/* borders included */
+bool
+BoundingBox::contains(const Point &point) const
+{
+    return this->defined
+        && point.x >= this->min.x && point.x <= this->max.x
+        && point.y >= this->min.y && point.y <= this->max.y;
+}
+
+/* touching boxes overlap */
+bool
+BoundingBox::overlap(const BoundingBox &other) const
+{
+    return this->defined && other.defined
+        && this->min.x <= other.max.x && other.min.x <= this->max.x
+        && this->min.y <= other.max.y && other.min.y <= this->max.y;
+}
+
+void
+BoundingBox3::merge(double x, double y, double z)
+{
+    if (this->defined) {
+        this->min_x = std::min(x, this->min_x);
+        this->min_y = std::min(y, this->min_y);
+        this->min_z = std::min(z, this->min_z);
+        this->max_x = std::max(x, this->max_x);
+        this->max_y = std::max(y, this->max_y);
+        this->max_z = std::max(z, this->max_z);
+    } else {
+        this->min_x = this->max_x = x;
+        this->min_y = this->max_y = y;
+        this->min_z = this->max_z = z;
+        this->defined = true;
+    }
+}
+
+void
+BoundingBox3::merge(const BoundingBox3 &bb)
+{
+    if (!bb.defined) return;
+    this->merge(bb.min_x, bb.min_y, bb.min_z);
+    this->merge(bb.max_x, bb.max_y, bb.max_z);
+}
+
+void
+BoundingBox3::scale(double factor)
+{
+    this->min_x *= factor;
+    this->min_y *= factor;
+    this->min_z *= factor;
+    this->max_x *= factor;
+    this->max_y *= factor;
+    this->max_z *= factor;
+}
+
+void
+BoundingBox3::translate(double x, double y, double z)
+{
+    this->min_x += x;
+    this->min_y += y;
+    this->min_z += z;
+    this->max_x += x;
+    this->max_y += y;
+    this->max_z += z;
+}
+
+void
+BoundingBox3::offset(double delta)
+{
+    this->min_x -= delta;
+    this->min_y -= delta;
+    this->min_z -= delta;
+    this->max_x += delta;
+    this->max_y += delta;
+    this->max_z += delta;
+}
+
+void
+BoundingBox3::size(double &x, double &y, double &z) const
+{
+    x = this->max_x - this->min_x;
+    y = this->max_y - this->min_y;
+    z = this->max_z - this->min_z;
+}
+
+void
+BoundingBox3::center(double &x, double &y, double &z) const
+{
+    x = (this->min_x + this->max_x) / 2;
+    y = (this->min_y + this->max_y) / 2;
+    z = (this->min_z + this->max_z) / 2;
+}
+
+bool
+BoundingBox3::contains(double x, double y, double z) const
+{
+    return this->defined
+        && x >= this->min_x && x <= this->max_x
+        && y >= this->min_y && y <= this->max_y
+        && z >= this->min_z && z <= this->max_z;
+}
+
+bool
+BoundingBox3::overlap(const BoundingBox3 &other) const
+{
+    return this->defined && other.defined
+        && this->min_x <= other.max_x && other.min_x <= this->max_x
+        && this->min_y <= other.max_y && other.min_y <= this->max_y
+        && this->min_z <= other.max_z && other.min_z <= this->max_z;
+}
+
+}
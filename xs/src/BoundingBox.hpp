@@ -0,0 +1,55 @@
+#ifndef slic3r_BoundingBox_hpp_
+#define slic3r_BoundingBox_hpp_
+
+#include <myinit.h>
+#include "Point.hpp"
+
+namespace Slic3r {
+
+class Polygon;
+
+/* axis-aligned 2D box in scaled coordinates; min and max are meaningless
+   until something has been merged into it (see defined) */
+class BoundingBox
+{
+    public:
+    Point min;
+    Point max;
+    bool defined;
+    BoundingBox() : defined(false) {};
+    explicit BoundingBox(const Points &points);
+    void merge(const Point &point);
+    void merge(const Points &points);
+    void merge(const BoundingBox &bb);
+    void scale(double factor);
+    void translate(double x, double y);
+    void offset(double delta);
+    void polygon(Polygon* polygon) const;
+    Point size() const;
+    Point center() const;
+    bool contains(const Point &point) const;
+    bool overlap(const BoundingBox &other) const;
+};
+
+/* axis-aligned 3D box in unscaled coordinates, as used for meshes */
+class BoundingBox3
+{
+    public:
+    double min_x, min_y, min_z;
+    double max_x, max_y, max_z;
+    bool defined;
+    BoundingBox3() : min_x(0), min_y(0), min_z(0), max_x(0), max_y(0), max_z(0), defined(false) {};
+    void merge(double x, double y, double z);
+    void merge(const BoundingBox3 &bb);
+    void scale(double factor);
+    void translate(double x, double y, double z);
+    void offset(double delta);
+    void size(double &x, double &y, double &z) const;
+    void center(double &x, double &y, double &z) const;
+    bool contains(double x, double y, double z) const;
+    bool overlap(const BoundingBox3 &other) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+#include "BridgeDetector.hpp"
+#include "ClipperUtils.hpp"
+#include "ExPolygonCollection.hpp"
+#include "Geometry.hpp"
+#include <algorithm>
+
+namespace Slic3r {
+
+/* direction of the segment from a to b, folded into [0, PI) */
+static double
+line_direction(const Point &a, const Point &b)
+{
+    double angle = atan2((double)b.y - a.y, (double)b.x - a.x);
+    if (angle < 0) angle += PI;
+    if (angle >= PI) angle -= PI;
+    return angle;
+}
+
+BridgeDetector::BridgeDetector(const ExPolygon &_expolygon, const ExPolygons &_lower_slices,
+    coord_t _extrusion_width, coord_t _line_spacing)
+    : expolygon(_expolygon), extrusion_width(_extrusion_width), line_spacing(_line_spacing),
+      angle(-1), coverage(0)
+{
+    /* outset our bridge by the extrusion width; this outer margin is what
+       finds the edges and anchors */
+    Polygons grown;
+    offset((Polygons)this->expolygon, grown, this->extrusion_width);
+    
+    // turn bridge contour and holes into polylines and then clip them
+    // with each lower slice's contour
+    Polylines grown_pl;
+    for (Polygons::const_iterator p = grown.begin(); p != grown.end(); ++p) {
+        Polyline pl;
+        pl.points = p->points;
+        pl.points.push_back(p->points.front());
+        grown_pl.push_back(pl);
+    }
+    Polygons lower_polygons;
+    for (ExPolygons::const_iterator lower = _lower_slices.begin(); lower != _lower_slices.end(); ++lower) {
+        Polylines clipped;
+        intersection(grown_pl, Polygons(1, lower->contour), clipped);
+        if (clipped.size() == 2) {
+            // if the polygon was split inside the clipping area we get two
+            // consecutive polylines instead of a single one, so recombine them
+            if (clipped.front().first_point().coincides_with(clipped.back().last_point())) {
+                clipped.back().points.insert(clipped.back().points.end(),
+                    clipped.front().points.begin() + 1, clipped.front().points.end());
+                clipped.erase(clipped.begin());
+            } else if (clipped.back().first_point().coincides_with(clipped.front().last_point())) {
+                clipped.front().points.insert(clipped.front().points.end(),
+                    clipped.back().points.begin() + 1, clipped.back().points.end());
+                clipped.pop_back();
+            }
+        }
+        this->edges.insert(this->edges.end(), clipped.begin(), clipped.end());
+    
+        Polygons pp = *lower;
+        lower_polygons.insert(lower_polygons.end(), pp.begin(), pp.end());
+    }
+    
+    // safety offset required to avoid Clipper from detecting empty intersection while the edges were found
+    intersection(grown, lower_polygons, this->anchors, true);
+    
+    /* test lines are clipped by the bridge grown by half the margin, so that
+       their endpoints fall inside the anchors rather than on their outline;
+       the Perl detector grew it by the infill width (line_spacing) instead,
+       which puts them on the outline or, with an infill wider than the
+       margin, beyond the anchors so that nothing is bridged */
+    offset((Polygons)this->expolygon, this->clip_area, this->extrusion_width / 2);
+}
+
+bool
+BridgeDetector::detect_angle()
+{
+    this->angle = -1;
+    this->coverage = 0;
+    if (this->edges.empty()) return false;
+    
+    std::vector<Candidate> candidates;
+    if (this->edges.size() == 2) {
+        // bridge from the middle of one supporting edge to the middle of the other
+        const Point m1 = Line(this->edges[0].first_point(), this->edges[0].last_point()).midpoint();
+        const Point m2 = Line(this->edges[1].first_point(), this->edges[1].last_point()).midpoint();
+        candidates.push_back(Candidate(line_direction(m1, m2)));
+    } else if (this->edges.size() == 1) {
+        /* TODO: this case includes both U-shaped bridges and plain overhangs;
+           until the bridged area is told apart from the overhang, a straight
+           supporting edge is treated as an overhang */
+        if (this->edges.front().points.size() <= 2) return false;
+        candidates.push_back(Candidate(line_direction(this->edges.front().first_point(), this->edges.front().last_point())));
+    } else {
+        std::vector<double> angles;
+        this->candidate_angles(angles);
+        candidates.assign(angles.begin(), angles.end());
+    }
+    this->evaluate(candidates);
+    
+    if (candidates.size() == 1) {
+        this->angle = candidates.front().angle;
+        this->coverage = candidates.front().coverage;
+        return true;
+    }
+    
+    /* directions bridging about as much as the best one are told apart by
+       their longest bridged line, the shorter the better */
+    double best_coverage = 0;
+    for (std::vector<Candidate>::const_iterator c = candidates.begin(); c != candidates.end(); ++c)
+        best_coverage = std::max(best_coverage, c->coverage);
+    // no direction bridges anything
+    if (best_coverage == 0) return false;
+    
+    const Candidate* best = NULL;
+    for (std::vector<Candidate>::const_iterator c = candidates.begin(); c != candidates.end(); ++c) {
+        if (c->coverage < best_coverage * (1 - BRIDGE_COVERAGE_TOLERANCE)) continue;
+        if (best == NULL || c->max_length < best->max_length) best = &*c;
+    }
+    this->angle = best->angle;
+    this->coverage = best->coverage;
+    return true;
+}
+
+/* The fixed sweep plus the directions suggested by the geometry: the chord of
+   each supporting edge, the line joining the chord midpoints of each pair of
+   edges (i.e. from one anchor to another) and the edges of the bridge's convex
+   hull. Sorted, with angles closer than BRIDGE_MIN_ANGLE_DIFFERENCE merged. */
+void
+BridgeDetector::candidate_angles(std::vector<double> &retval) const
+{
+    for (int i = 0; i * BRIDGE_ANGLE_RESOLUTION < PI - EPSILON; ++i)
+        retval.push_back(i * BRIDGE_ANGLE_RESOLUTION);
+    
+    Points midpoints;
+    for (Polylines::const_iterator edge = this->edges.begin(); edge != this->edges.end(); ++edge) {
+        if (edge->first_point().coincides_with(edge->last_point())) continue;
+        retval.push_back(line_direction(edge->first_point(), edge->last_point()));
+        midpoints.push_back(Line(edge->first_point(), edge->last_point()).midpoint());
+    }
+    for (Points::const_iterator m1 = midpoints.begin(); m1 != midpoints.end(); ++m1) {
+        for (Points::const_iterator m2 = m1 + 1; m2 != midpoints.end(); ++m2) {
+            if (!m1->coincides_with(*m2)) retval.push_back(line_direction(*m1, *m2));
+        }
+    }
+    
+    if (this->expolygon.contour.points.size() >= 3) {
+        Points points = this->expolygon.contour.points;
+        Polygon hull;
+        Geometry::convex_hull(points, &hull);
+        Lines lines = hull.lines();
+        for (Lines::const_iterator line = lines.begin(); line != lines.end(); ++line) {
+            if (!line->a.coincides_with(line->b)) retval.push_back(line_direction(line->a, line->b));
+        }
+    }
+    
+    std::sort(retval.begin(), retval.end());
+    std::vector<double>::iterator last = retval.begin();
+    for (std::vector<double>::iterator a = retval.begin() + 1; a != retval.end(); ++a) {
+        if (*a - *last >= BRIDGE_MIN_ANGLE_DIFFERENCE) *++last = *a;
+    }
+    retval.erase(last + 1, retval.end());
+    // the last angle may be parallel to the first one (close to PI vs 0)
+    if (retval.size() > 1 && retval.front() + PI - retval.back() < BRIDGE_MIN_ANGLE_DIFFERENCE)
+        retval.pop_back();
+}
+
+/* Test lines for the given direction, laid across the anchors' extent at
+   line_spacing intervals. They are returned in the frame rotated by
+   PI/2 - angle, where they are all vertical and share their endpoints'
+   ordinates: Clipper sweeps them in two scanbeams, while slanted lines would
+   need two for each line. */
+void
+BridgeDetector::test_lines(double angle, Polylines &lines) const
+{
+    // extent of the anchors in the rotated frame
+    const double c = cos(angle), s = sin(angle);
+    const Point &first = this->anchors.front().contour.points.front();
+    double x_min = first.x * s - first.y * c, x_max = x_min;
+    double y_min = first.x * c + first.y * s, y_max = y_min;
+    for (ExPolygons::const_iterator anchor = this->anchors.begin(); anchor != this->anchors.end(); ++anchor) {
+        // holes are within the contour
+        for (Points::const_iterator p = anchor->contour.points.begin(); p != anchor->contour.points.end(); ++p) {
+            const double x = p->x * s - p->y * c, y = p->x * c + p->y * s;
+            x_min = std::min(x_min, x);
+            x_max = std::max(x_max, x);
+            y_min = std::min(y_min, y);
+            y_max = std::max(y_max, y);
+        }
+    }
+    
+    const coord_t bottom = (coord_t)floor(y_min), top = (coord_t)ceil(y_max);
+    for (coord_t x = (coord_t)floor(x_min); x <= x_max; x += this->line_spacing) {
+        Polyline line;
+        line.points.push_back(Point(x, bottom));
+        line.points.push_back(Point(x, top));
+        lines.push_back(line);
+    }
+}
+
+/* Scores each candidate by the total length of its test lines bridging the
+   area, i.e. lying over the bridge with both endpoints within anchors. Each
+   direction gets its own Clipper call since parallel lines never cross each
+   other, while clipping the lines of several directions together would make
+   Clipper compute all of their intersections. */
+void
+BridgeDetector::evaluate(std::vector<Candidate> &candidates) const
+{
+    if (this->anchors.empty()) return;
+    
+    ExPolygonCollectionIndex anchors_index(this->anchors);
+    Point origin(0,0);
+    for (std::vector<Candidate>::iterator c = candidates.begin(); c != candidates.end(); ++c) {
+        const double rotation = PI/2 - c->angle;
+        Polygons clip_area = this->clip_area;
+        for (Polygons::iterator p = clip_area.begin(); p != clip_area.end(); ++p)
+            p->rotate(rotation, &origin);
+        Polylines lines;
+        this->test_lines(c->angle, lines);
+        Polylines clipped;
+        intersection(lines, clip_area, clipped);
+        
+        for (Polylines::const_iterator line = clipped.begin(); line != clipped.end(); ++line) {
+            Point a = line->first_point(), b = line->last_point();
+            a.rotate(-rotation, &origin);
+            b.rotate(-rotation, &origin);
+            if (!anchors_index.contains_point(a) || !anchors_index.contains_point(b)) continue;
+            const double length = line->length();
+            c->coverage += length;
+            c->max_length = std::max(c->max_length, length);
+        }
+    }
+}
+
+}
@@ -0,0 +1,57 @@
+#ifndef slic3r_BridgeDetector_hpp_
+#define slic3r_BridgeDetector_hpp_
+
+#include <myinit.h>
+#include "ExPolygon.hpp"
+#include "Polyline.hpp"
+#include <vector>
+
+// step of the fixed sweep tested along with the candidates derived from the geometry
+#define BRIDGE_ANGLE_RESOLUTION (PI/36)
+
+// candidate angles closer than this are only tested once
+#define BRIDGE_MIN_ANGLE_DIFFERENCE (PI/180)
+
+// candidates covering at least this much less than the best one are out of the running
+#define BRIDGE_COVERAGE_TOLERANCE 0.01
+
+namespace Slic3r {
+
+/* Finds the direction in which a bridge should be extruded. The supporting
+   edges are the parts of the bridge outline (grown by the extrusion width)
+   lying over the lower slices, and the anchors are the areas they enclose
+   there. One or two edges give the direction right away; otherwise every
+   candidate angle is scored by the total length of parallel test lines
+   crossing the bridge with both endpoints in anchors. Angles are in radians,
+   within [0, PI), and give the direction of the bridge lines. */
+class BridgeDetector
+{
+    public:
+    ExPolygon expolygon;
+    coord_t extrusion_width;  // margin used to find edges and anchors
+    coord_t line_spacing;     // distance between test lines
+    Polylines edges;
+    ExPolygons anchors;
+    double angle;             // best direction, -1 if none was found
+    double coverage;          // length of the test lines bridged along it
+    BridgeDetector(const ExPolygon &_expolygon, const ExPolygons &_lower_slices,
+        coord_t _extrusion_width, coord_t _line_spacing);
+    bool detect_angle();
+    
+    private:
+    struct Candidate
+    {
+        double angle;
+        double coverage;      // total length of the bridged test lines
+        double max_length;    // longest bridged test line
+        Candidate(double _angle): angle(_angle), coverage(0), max_length(0) {};
+    };
+    Polygons clip_area;       // bridge grown by half the extrusion width
+    void candidate_angles(std::vector<double> &retval) const;
+    void test_lines(double angle, Polylines &lines) const;
+    void evaluate(std::vector<Candidate> &candidates) const;
+};
+
+}
+
+#endif
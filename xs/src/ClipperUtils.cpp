@@ -1,8 +1,43 @@
 #include "ClipperUtils.hpp"
 #include "Geometry.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <list>
+#include <map>
 
 namespace Slic3r {
 
+struct ThreadClipper
+{
+    ClipperLib::Clipper clipper;
+    bool busy;
+    ThreadClipper() : busy(false) {};
+};
+static ThreadLocal<ThreadClipper> thread_clipper;
+
+ClipperContext::ClipperContext()
+{
+    ThreadClipper* tc = thread_clipper.get();
+    if (tc->busy) {
+        this->_clipper = new ClipperLib::Clipper();
+        this->_busy    = NULL;
+    } else {
+        this->_clipper = &tc->clipper;
+        this->_busy    = &tc->busy;
+        tc->busy = true;
+    }
+}
+
+ClipperContext::~ClipperContext()
+{
+    if (this->_busy == NULL) {
+        delete this->_clipper;
+    } else {
+        this->_clipper->TrimMemory(CLIPPER_ARENA_MAX_CAPACITY);
+        *this->_busy = false;
+    }
+}
+
 //-----------------------------------------------------------
 // legacy code from Clipper documentation
 void AddOuterPolyNodeToExPolygons(ClipperLib::PolyNode& polynode, Slic3r::ExPolygons& expolygons)
@@ -37,6 +72,7 @@ ClipperPath_to_Slic3rMultiPoint(const ClipperLib::Path &input, T &output)
         output.points.push_back(Slic3r::Point( (*pit).X, (*pit).Y ));
     }
 }
+template void ClipperPath_to_Slic3rMultiPoint<Slic3r::Polygon>(const ClipperLib::Path &input, Slic3r::Polygon &output);
 
 template <class T>
 void
@@ -54,13 +90,12 @@ void
 ClipperPaths_to_Slic3rExPolygons(const ClipperLib::Paths &input, Slic3r::ExPolygons &output)
 {
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    ClipperContext clipper;
     
     // perform union
-    clipper.AddPaths(input, ClipperLib::ptSubject, true);
+    clipper->AddPaths(input, ClipperLib::ptSubject, true);
     ClipperLib::PolyTree* polytree = new ClipperLib::PolyTree();
-    clipper.Execute(ClipperLib::ctUnion, *polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);  // offset results work with both EvenOdd and NonZero
+    clipper->Execute(ClipperLib::ctUnion, *polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);  // offset results work with both EvenOdd and NonZero
     
     // write to ExPolygons object
     output.clear();
@@ -101,8 +136,140 @@ scaleClipperPolygons(ClipperLib::Paths &polygons, const double scale)
     }
 }
 
+/* offset parameters plus a hash of the input polygons */
+struct OffsetKey
+{
+    size_t hash;
+    float delta1, delta2;
+    double scale, miterLimit;
+    int joinType, steps;
+    bool operator<(const OffsetKey &other) const
+    {
+        if (this->hash != other.hash) return this->hash < other.hash;
+        if (this->delta1 != other.delta1) return this->delta1 < other.delta1;
+        if (this->delta2 != other.delta2) return this->delta2 < other.delta2;
+        if (this->scale != other.scale) return this->scale < other.scale;
+        if (this->miterLimit != other.miterLimit) return this->miterLimit < other.miterLimit;
+        if (this->joinType != other.joinType) return this->joinType < other.joinType;
+        return this->steps < other.steps;
+    };
+};
+
+class OffsetCache
+{
+    public:
+    OffsetKey key(const Slic3r::Polygons &polygons, float delta1, float delta2, double scale,
+        ClipperLib::JoinType joinType, double miterLimit, int steps) const;
+    bool lookup(const OffsetKey &key, const Slic3r::Polygons &polygons, ClipperLib::Paths &retval);
+    void store(const OffsetKey &key, const Slic3r::Polygons &polygons, const ClipperLib::Paths &result);
+    void clear();
+    
+    private:
+    struct Entry {
+        Slic3r::Polygons input;    // to tell hash collisions apart
+        ClipperLib::Paths output;
+    };
+    typedef std::list< std::pair<OffsetKey,Entry> > EntryList;
+    EntryList entries;    // most recently used first
+    std::map<OffsetKey,EntryList::iterator> index;
+};
+
+static size_t offset_cache_capacity = 0;
+static ThreadCounter offset_cache_hits;
+static ThreadCounter offset_cache_misses;
+static ThreadLocal<OffsetCache> thread_offset_cache;
+
+OffsetKey
+OffsetCache::key(const Slic3r::Polygons &polygons, float delta1, float delta2, double scale,
+    ClipperLib::JoinType joinType, double miterLimit, int steps) const
+{
+    // FNV-1a over the coordinates, with the number of points closing each polygon
+    size_t h = 2166136261u;
+    for (Slic3r::Polygons::const_iterator p = polygons.begin(); p != polygons.end(); ++p) {
+        for (Slic3r::Points::const_iterator pt = p->points.begin(); pt != p->points.end(); ++pt) {
+            h = (h ^ (size_t)pt->x) * 16777619u;
+            h = (h ^ (size_t)pt->y) * 16777619u;
+        }
+        h = (h ^ p->points.size()) * 16777619u;
+    }
+    OffsetKey key = { h, delta1, delta2, scale, miterLimit, (int)joinType, steps };
+    return key;
+}
+
+bool
+OffsetCache::lookup(const OffsetKey &key, const Slic3r::Polygons &polygons, ClipperLib::Paths &retval)
+{
+    std::map<OffsetKey,EntryList::iterator>::iterator it = this->index.find(key);
+    bool hit = false;
+    if (it != this->index.end() && it->second->second.input.size() == polygons.size()) {
+        hit = true;
+        for (size_t i = 0; hit && i < polygons.size(); ++i) {
+            const Slic3r::Points &a = it->second->second.input[i].points, &b = polygons[i].points;
+            hit = a.size() == b.size();
+            for (size_t j = 0; hit && j < a.size(); ++j) hit = a[j].coincides_with(b[j]);
+        }
+    }
+    if (hit) {
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+        retval = it->second->second.output;
+    }
+    
+    if (hit) offset_cache_hits.increment(); else offset_cache_misses.increment();
+    return hit;
+}
+
+void
+OffsetCache::store(const OffsetKey &key, const Slic3r::Polygons &polygons, const ClipperLib::Paths &result)
+{
+    std::map<OffsetKey,EntryList::iterator>::iterator it = this->index.find(key);
+    if (it != this->index.end()) {
+        // a colliding entry: replace it
+        this->entries.erase(it->second);
+        this->index.erase(it);
+    }
+    while (!this->entries.empty() && this->entries.size() >= offset_cache_capacity) {
+        this->index.erase(this->entries.back().first);
+        this->entries.pop_back();
+    }
+    
+    this->entries.push_front(std::make_pair(key, Entry()));
+    this->entries.front().second.input  = polygons;
+    this->entries.front().second.output = result;
+    this->index[key] = this->entries.begin();
+}
+
 void
-offset(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float delta,
+OffsetCache::clear()
+{
+    this->entries.clear();
+    this->index.clear();
+}
+
+/* this is meant to be called before spawning threads */
+void
+offset_cache_enable(size_t capacity)
+{
+    offset_cache_capacity = capacity;
+    offset_cache_hits.reset();
+    offset_cache_misses.reset();
+    thread_offset_cache.get()->clear();
+}
+
+void
+offset_cache_clear()
+{
+    thread_offset_cache.get()->clear();
+}
+
+void
+offset_cache_stats(size_t &hits, size_t &misses)
+{
+    hits   = offset_cache_hits.sum();
+    misses = offset_cache_misses.sum();
+}
+
+static void
+_offset(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float delta,
     double scale, ClipperLib::JoinType joinType, double miterLimit)
 {
     // read input
@@ -120,6 +287,21 @@ offset(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float
     scaleClipperPolygons(retval, 1/scale);
 }
 
+void
+offset(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float delta,
+    double scale, ClipperLib::JoinType joinType, double miterLimit)
+{
+    if (offset_cache_capacity == 0) {
+        _offset(polygons, retval, delta, scale, joinType, miterLimit);
+        return;
+    }
+    OffsetCache* cache = thread_offset_cache.get();
+    OffsetKey key = cache->key(polygons, delta, 0, scale, joinType, miterLimit, 1);
+    if (cache->lookup(key, polygons, retval)) return;
+    _offset(polygons, retval, delta, scale, joinType, miterLimit);
+    cache->store(key, polygons, retval);
+}
+
 void
 offset(const Slic3r::Polygons &polygons, Slic3r::Polygons &retval, const float delta,
     double scale, ClipperLib::JoinType joinType, double miterLimit)
@@ -196,8 +378,8 @@ offset_ex(const Slic3r::Polygons &polygons, Slic3r::ExPolygons &retval, const fl
     delete output;
 }
 
-void
-offset2(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float delta1,
+static void
+_offset2(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float delta1,
     const float delta2, const double scale, const ClipperLib::JoinType joinType, const double miterLimit)
 {
     // read input
@@ -220,6 +402,21 @@ offset2(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float
     scaleClipperPolygons(retval, 1/scale);
 }
 
+void
+offset2(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float delta1,
+    const float delta2, const double scale, const ClipperLib::JoinType joinType, const double miterLimit)
+{
+    if (offset_cache_capacity == 0) {
+        _offset2(polygons, retval, delta1, delta2, scale, joinType, miterLimit);
+        return;
+    }
+    OffsetCache* cache = thread_offset_cache.get();
+    OffsetKey key = cache->key(polygons, delta1, delta2, scale, joinType, miterLimit, 2);
+    if (cache->lookup(key, polygons, retval)) return;
+    _offset2(polygons, retval, delta1, delta2, scale, joinType, miterLimit);
+    cache->store(key, polygons, retval);
+}
+
 void
 offset2(const Slic3r::Polygons &polygons, Slic3r::Polygons &retval, const float delta1,
     const float delta2, const double scale, const ClipperLib::JoinType joinType, const double miterLimit)
@@ -266,17 +463,16 @@ void _clipper_do(const ClipperLib::ClipType clipType, const Slic3r::Polygons &su
     }
     
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    ClipperContext clipper;
     
     // add polygons
-    clipper.AddPaths(*input_subject, ClipperLib::ptSubject, true);
+    clipper->AddPaths(*input_subject, ClipperLib::ptSubject, true);
     delete input_subject;
-    clipper.AddPaths(*input_clip, ClipperLib::ptClip, true);
+    clipper->AddPaths(*input_clip, ClipperLib::ptClip, true);
     delete input_clip;
     
     // perform operation
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
 }
 
 void _clipper_do(const ClipperLib::ClipType clipType, const Slic3r::Polylines &subject, 
@@ -289,17 +485,16 @@ void _clipper_do(const ClipperLib::ClipType clipType, const Slic3r::Polylines &s
     Slic3rMultiPoints_to_ClipperPaths(clip,    *input_clip);
     
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    ClipperContext clipper;
     
     // add polygons
-    clipper.AddPaths(*input_subject, ClipperLib::ptSubject, false);
+    clipper->AddPaths(*input_subject, ClipperLib::ptSubject, false);
     delete input_subject;
-    clipper.AddPaths(*input_clip, ClipperLib::ptClip, true);
+    clipper->AddPaths(*input_clip, ClipperLib::ptClip, true);
     delete input_clip;
     
     // perform operation
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
 }
 
 void _clipper(ClipperLib::ClipType clipType, const Slic3r::Polygons &subject, 
@@ -380,6 +575,168 @@ void union_(const Slic3r::Polygons &subject, T &retval, bool safety_offset_)
 template void union_<Slic3r::ExPolygons>(const Slic3r::Polygons &subject, Slic3r::ExPolygons &retval, bool safety_offset_);
 template void union_<Slic3r::Polygons>(const Slic3r::Polygons &subject, Slic3r::Polygons &retval, bool safety_offset_);
 
+/* unions each input group independently; used by union_parallel() both for
+   the initial groups and for the pairwise merges of their results */
+class ParallelUnionJob : public ParallelJob
+{
+    public:
+    std::vector<ClipperLib::Paths> input;
+    std::vector<ClipperLib::Paths> output;
+    bool safety_offset_;
+    ParallelUnionJob(size_t groups, bool _safety_offset)
+        : input(groups), output(groups), safety_offset_(_safety_offset) {};
+    void run(size_t idx)
+    {
+        ClipperLib::Paths* input_subject = new ClipperLib::Paths();
+        input_subject->swap(this->input[idx]);
+        if (this->safety_offset_) safety_offset(input_subject);
+        
+        ClipperContext clipper;
+        clipper->AddPaths(*input_subject, ClipperLib::ptSubject, true);
+        delete input_subject;
+        clipper->Execute(ClipperLib::ctUnion, this->output[idx], ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    }
+};
+
+/* the outline used to place an item in a strip, and the rings it brings to
+   the union: holes stay with their contour, oriented so that each item has
+   a winding number of either 0 or 1 everywhere */
+static const Points&
+union_item_outline(const Slic3r::Polygon &polygon)
+{
+    return polygon.points;
+}
+
+static const Points&
+union_item_outline(const Slic3r::ExPolygon &expolygon)
+{
+    return expolygon.contour.points;
+}
+
+static void
+union_item_paths(const Slic3r::Polygon &polygon, ClipperLib::Paths &paths)
+{
+    paths.push_back(ClipperLib::Path());
+    Slic3rMultiPoint_to_ClipperPath(polygon, paths.back());
+}
+
+static void
+union_item_paths(const Slic3r::ExPolygon &expolygon, ClipperLib::Paths &paths)
+{
+    paths.push_back(ClipperLib::Path());
+    Slic3rMultiPoint_to_ClipperPath(expolygon.contour, paths.back());
+    if (!ClipperLib::Orientation(paths.back())) ClipperLib::ReversePath(paths.back());
+    for (Polygons::const_iterator hole = expolygon.holes.begin(); hole != expolygon.holes.end(); ++hole) {
+        paths.push_back(ClipperLib::Path());
+        Slic3rMultiPoint_to_ClipperPath(*hole, paths.back());
+        if (ClipperLib::Orientation(paths.back())) ClipperLib::ReversePath(paths.back());
+    }
+}
+
+/* Large inputs are split into spatially coherent groups of whole items which
+   are unioned concurrently and then merged pairwise. Since each item, and
+   the output of each union, has a winding number of either 0 or 1
+   everywhere, the non-zero union of partial results covers exactly the same
+   area as the single-call union. */
+template <class S, class T>
+static void
+_union_parallel(const std::vector<S> &subject, T &retval, bool safety_offset_, unsigned int threads)
+{
+    /* sort items by the X coordinate of their bounding box center so that each
+       group is a vertical strip and merges only need to resolve the strip borders */
+    std::vector< std::pair<coord_t,size_t> > order;
+    order.reserve(subject.size());
+    for (typename std::vector<S>::const_iterator it = subject.begin(); it != subject.end(); ++it) {
+        const Points &outline = union_item_outline(*it);
+        if (outline.empty()) continue;
+        coord_t min_x = outline.front().x;
+        coord_t max_x = min_x;
+        for (Points::const_iterator p = outline.begin() + 1; p != outline.end(); ++p) {
+            if (p->x < min_x) min_x = p->x;
+            if (p->x > max_x) max_x = p->x;
+        }
+        order.push_back(std::make_pair(min_x/2 + max_x/2, it - subject.begin()));
+    }
+    std::sort(order.begin(), order.end());
+    
+    /* splitting pays off even on a single core because the cost of the sweep
+       grows faster than linearly with the number of edges */
+    if (threads == 0) threads = hardware_threads();
+    size_t groups = std::min<size_t>(order.size() / (CLIPPER_PARALLEL_UNION_THRESHOLD/2), 2*threads);
+    if (groups < 2) groups = 2;
+    ParallelUnionJob job(groups, safety_offset_);
+    for (size_t g = 0; g < groups; ++g) {
+        size_t first = g * order.size() / groups;
+        size_t last  = (g+1) * order.size() / groups;
+        for (size_t i = first; i < last; ++i)
+            union_item_paths(subject[ order[i].second ], job.input[g]);
+    }
+    parallelize(job, groups, threads);
+    
+    // merge neighbor results pairwise until only two are left
+    std::vector<ClipperLib::Paths> results;
+    results.swap(job.output);
+    while (results.size() > 2) {
+        size_t pairs = results.size() / 2;
+        ParallelUnionJob merge(pairs, false);
+        for (size_t i = 0; i < pairs; ++i) {
+            merge.input[i].swap(results[2*i]);
+            merge.input[i].insert(merge.input[i].end(), results[2*i+1].begin(), results[2*i+1].end());
+        }
+        parallelize(merge, pairs, threads);
+        if (results.size() % 2) merge.output.push_back(results.back());
+        results.swap(merge.output);
+    }
+    
+    // the last merge also builds the requested output type
+    ClipperLib::Paths paths;
+    paths.swap(results.front());
+    paths.insert(paths.end(), results.back().begin(), results.back().end());
+    Slic3r::Polygons pp;
+    ClipperPaths_to_Slic3rMultiPoints(paths, pp);
+    _clipper(ClipperLib::ctUnion, pp, Slic3r::Polygons(), retval, false);
+}
+
+/* Same result as union_(), using up to threads threads (0 means one per
+   core). A clockwise ring can't be told apart from a hole of some other ring
+   whose strip it may not share, so inputs having any are unioned in a
+   single call: pass expolygons to keep holes with their contours. */
+template <class T>
+void union_parallel(const Slic3r::Polygons &subject, T &retval, bool safety_offset_, unsigned int threads)
+{
+    bool has_cw = false;
+    for (Polygons::const_iterator it = subject.begin(); it != subject.end() && !has_cw; ++it)
+        has_cw = !it->is_counter_clockwise();
+    if (subject.size() < CLIPPER_PARALLEL_UNION_THRESHOLD || has_cw) {
+        union_(subject, retval, safety_offset_);
+        return;
+    }
+    _union_parallel(subject, retval, safety_offset_, threads);
+}
+template void union_parallel<Slic3r::ExPolygons>(const Slic3r::Polygons &subject, Slic3r::ExPolygons &retval, bool safety_offset_, unsigned int threads);
+template void union_parallel<Slic3r::Polygons>(const Slic3r::Polygons &subject, Slic3r::Polygons &retval, bool safety_offset_, unsigned int threads);
+
+template <class T>
+void union_parallel(const Slic3r::ExPolygons &subject, T &retval, bool safety_offset_, unsigned int threads)
+{
+    size_t rings = 0;
+    for (ExPolygons::const_iterator it = subject.begin(); it != subject.end(); ++it)
+        rings += 1 + it->holes.size();
+    if (rings < CLIPPER_PARALLEL_UNION_THRESHOLD || subject.size() < 2) {
+        Slic3r::Polygons pp;
+        pp.reserve(rings);
+        for (ExPolygons::const_iterator it = subject.begin(); it != subject.end(); ++it) {
+            Polygons p = *it;
+            pp.insert(pp.end(), p.begin(), p.end());
+        }
+        union_(pp, retval, safety_offset_);
+        return;
+    }
+    _union_parallel(subject, retval, safety_offset_, threads);
+}
+template void union_parallel<Slic3r::ExPolygons>(const Slic3r::ExPolygons &subject, Slic3r::ExPolygons &retval, bool safety_offset_, unsigned int threads);
+template void union_parallel<Slic3r::Polygons>(const Slic3r::ExPolygons &subject, Slic3r::Polygons &retval, bool safety_offset_, unsigned int threads);
+
 void union_pt(const Slic3r::Polygons &subject, ClipperLib::PolyTree &retval, bool safety_offset_)
 {
     Slic3r::Polygons clip;
@@ -16,6 +16,33 @@ namespace Slic3r {
 
 #define CLIPPER_OFFSET_SCALE 100000.0
 
+// below this number of input polygons union_parallel() just calls union_()
+#define CLIPPER_PARALLEL_UNION_THRESHOLD 1000
+
+// arena memory that a thread's Clipper engine keeps (per arena) between operations
+#define CLIPPER_ARENA_MAX_CAPACITY (1024 * 1024)
+
+/* Hands out the calling thread's reusable Clipper engine (or a private one if
+   the thread's engine is already in use further up the stack) and clears it on
+   destruction, so that its arenas are recycled by the next operation instead
+   of allocating every internal record from the heap. Arena chunks beyond
+   CLIPPER_ARENA_MAX_CAPACITY are freed then, so that a huge operation doesn't
+   pin its memory for the lifetime of the thread. */
+class ClipperContext
+{
+    public:
+    ClipperContext();
+    ~ClipperContext();
+    ClipperLib::Clipper& operator*() { return *this->_clipper; };
+    ClipperLib::Clipper* operator->() { return this->_clipper; };
+    
+    private:
+    ClipperLib::Clipper* _clipper;
+    bool* _busy;
+    ClipperContext(const ClipperContext &);
+    ClipperContext& operator=(const ClipperContext &);
+};
+
 //-----------------------------------------------------------
 // legacy code from Clipper documentation
 void AddOuterPolyNodeToExPolygons(ClipperLib::PolyNode& polynode, Slic3r::ExPolygons& expolygons);
@@ -56,6 +83,17 @@ void offset_ex(const Slic3r::Polygons &polygons, Slic3r::ExPolygons &retval, con
     double scale = 100000, ClipperLib::JoinType joinType = ClipperLib::jtMiter, 
     double miterLimit = 3);
 
+/* offset() and offset2() on closed polygons can memoize their results, keyed
+   by the content of the input and the offset parameters, so that repeated
+   offsets of the same polygons become lookups. Each thread has its own cache
+   holding up to capacity results (the least recently used are evicted);
+   callers should clear it whenever they move on to another layer. A capacity
+   of 0 (the default) disables caching. Enabling or disabling resets the
+   process-wide hit/miss counters and clears the calling thread's cache. */
+void offset_cache_enable(size_t capacity);
+void offset_cache_clear();
+void offset_cache_stats(size_t &hits, size_t &misses);
+
 void offset2(const Slic3r::Polygons &polygons, ClipperLib::Paths &retval, const float delta1,
     const float delta2, double scale = 100000, ClipperLib::JoinType joinType = ClipperLib::jtMiter, 
     double miterLimit = 3);
@@ -94,6 +132,13 @@ void xor_ex(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, Slic3
 template <class T>
 void union_(const Slic3r::Polygons &subject, T &retval, bool safety_offset_ = false);
 
+template <class T>
+void union_parallel(const Slic3r::Polygons &subject, T &retval, bool safety_offset_ = false,
+    unsigned int threads = 0);
+template <class T>
+void union_parallel(const Slic3r::ExPolygons &subject, T &retval, bool safety_offset_ = false,
+    unsigned int threads = 0);
+
 void union_pt(const Slic3r::Polygons &subject, ClipperLib::PolyTree &retval, bool safety_offset_ = false);
 void union_pt_chained(const Slic3r::Polygons &subject, Slic3r::Polygons &retval, bool safety_offset_ = false);
 static void traverse_pt(ClipperLib::PolyNodes &nodes, Slic3r::Polygons &retval);
@@ -1,12 +1,15 @@
 #include "ExPolygon.hpp"
 #include "Polygon.hpp"
 #include "ClipperUtils.hpp"
+#include "Geometry.hpp"
+#include <algorithm>
 
 namespace Slic3r {
 
 ExPolygon::operator Polygons() const
 {
-    Polygons polygons(this->holes.size() + 1);
+    Polygons polygons;
+    polygons.reserve(this->holes.size() + 1);
     polygons.push_back(this->contour);
     for (Polygons::const_iterator it = this->holes.begin(); it != this->holes.end(); ++it) {
         polygons.push_back(*it);
@@ -41,6 +44,13 @@ ExPolygon::rotate(double angle, Point* center)
     }
 }
 
+/* holes can't extend beyond the contour */
+BoundingBox
+ExPolygon::bounding_box() const
+{
+    return this->contour.bounding_box();
+}
+
 double
 ExPolygon::area() const
 {
@@ -61,15 +71,169 @@ ExPolygon::is_valid() const
     return true;
 }
 
+/* Segment containment in a region considered as a closed set (lines running
+   along or touching the boundary are contained). The segment is fed the
+   region's edges: any proper crossing rejects it, while the points where it
+   touches the boundary split it into pieces which are each either running
+   along an edge or entirely inside or outside; the latter are told apart by
+   a point-in-region test of their midpoints. */
+class SegmentProbe
+{
+    public:
+    Line line;
+    coord_t min_x, max_x, min_y, max_y;
+    explicit SegmentProbe(const Line &_line);
+    bool crosses(const Point &p, const Point &q);
+    bool crosses(const Polygon &polygon);
+    void free_midpoints(std::vector<double> &retval);
+    
+    private:
+    std::vector<double> contacts;                        // parameters along line
+    std::vector< std::pair<double,double> > overlaps;    // parameter ranges along edges
+    double param(const Point &p) const;
+};
+
+static int
+orientation(const Point &o, const Point &a, const Point &b)
+{
+    coord2_t c = (coord2_t)(a.x - o.x) * (b.y - o.y) - (coord2_t)(a.y - o.y) * (b.x - o.x);
+    return (c > 0) - (c < 0);
+}
+
+SegmentProbe::SegmentProbe(const Line &_line)
+    : line(_line)
+{
+    this->min_x = std::min(line.a.x, line.b.x);
+    this->max_x = std::max(line.a.x, line.b.x);
+    this->min_y = std::min(line.a.y, line.b.y);
+    this->max_y = std::max(line.a.y, line.b.y);
+    this->contacts.push_back(0);
+    this->contacts.push_back(1);
+}
+
+double
+SegmentProbe::param(const Point &p) const
+{
+    double dx = this->line.b.x - this->line.a.x;
+    double dy = this->line.b.y - this->line.a.y;
+    return ((p.x - this->line.a.x) * dx + (p.y - this->line.a.y) * dy) / (dx*dx + dy*dy);
+}
+
+bool
+SegmentProbe::crosses(const Point &p, const Point &q)
+{
+    if (std::max(p.x, q.x) < this->min_x || std::min(p.x, q.x) > this->max_x
+        || std::max(p.y, q.y) < this->min_y || std::min(p.y, q.y) > this->max_y)
+        return false;
+    
+    int o1 = orientation(this->line.a, this->line.b, p);
+    int o2 = orientation(this->line.a, this->line.b, q);
+    if (o1 == 0 && o2 == 0) {
+        // collinear edge: remember the range the segment runs along it
+        double tp = this->param(p), tq = this->param(q);
+        double lo = std::max(0.0, std::min(tp, tq)), hi = std::min(1.0, std::max(tp, tq));
+        if (lo < hi) this->overlaps.push_back(std::make_pair(lo, hi));
+    }
+    if (o1 == 0) {
+        double t = this->param(p);
+        if (t > 0 && t < 1) this->contacts.push_back(t);
+    }
+    if (o2 == 0) {
+        double t = this->param(q);
+        if (t > 0 && t < 1) this->contacts.push_back(t);
+    }
+    if (o1 * o2 >= 0) return false;
+    
+    // the edge straddles the line: it's a proper crossing if the segment straddles the edge
+    int o3 = orientation(p, q, this->line.a);
+    int o4 = orientation(p, q, this->line.b);
+    return o3 * o4 < 0;
+}
+
+bool
+SegmentProbe::crosses(const Polygon &polygon)
+{
+    Points::const_iterator j = polygon.points.end() - 1;
+    for (Points::const_iterator i = polygon.points.begin(); i != polygon.points.end(); j = i++) {
+        if (this->crosses(*j, *i)) return true;
+    }
+    return false;
+}
+
+/* parameters of the midpoints of the pieces not running along the boundary */
+void
+SegmentProbe::free_midpoints(std::vector<double> &retval)
+{
+    std::sort(this->contacts.begin(), this->contacts.end());
+    for (size_t i = 1; i < this->contacts.size(); ++i) {
+        if (this->contacts[i] == this->contacts[i-1]) continue;
+        double t = (this->contacts[i-1] + this->contacts[i]) / 2;
+        bool on_boundary = false;
+        for (size_t k = 0; k < this->overlaps.size(); ++k) {
+            if (this->overlaps[k].first <= t && t <= this->overlaps[k].second) {
+                on_boundary = true;
+                break;
+            }
+        }
+        if (!on_boundary) retval.push_back(t);
+    }
+}
+
+/* flips inside when the edge crosses the horizontal ray going from (x, y) towards +X */
+static inline void
+toggle_if_crossing(double x, double y, const Point &p, const Point &q, bool &inside)
+{
+    if ((p.y > y) != (q.y > y) && x < (double)(q.x - p.x) * (y - p.y) / (q.y - p.y) + p.x)
+        inside = !inside;
+}
+
 bool
 ExPolygon::contains_line(const Line* line) const
 {
-    Polylines pl(1);
-    pl.push_back(*line);
+    if (line->a.coincides_with(line->b)) return this->contains_point(&line->a);
+    
+    SegmentProbe probe(*line);
+    if (probe.crosses(this->contour)) return false;
+    for (Polygons::const_iterator it = this->holes.begin(); it != this->holes.end(); ++it) {
+        if (probe.crosses(*it)) return false;
+    }
+    
+    std::vector<double> midpoints;
+    probe.free_midpoints(midpoints);
+    for (std::vector<double>::const_iterator t = midpoints.begin(); t != midpoints.end(); ++t) {
+        double x = line->a.x + (line->b.x - line->a.x) * *t;
+        double y = line->a.y + (line->b.y - line->a.y) * *t;
+        
+        // holes lie inside the contour, so the parity over all the rings is what we need
+        bool inside = false;
+        for (size_t k = 0; k <= this->holes.size(); ++k) {
+            const Points &pp = (k == 0) ? this->contour.points : this->holes[k-1].points;
+            Points::const_iterator j = pp.end() - 1;
+            for (Points::const_iterator i = pp.begin(); i != pp.end(); j = i++)
+                toggle_if_crossing(x, y, *j, *i, inside);
+        }
+        if (!inside) return false;
+    }
+    return true;
+}
+
+void
+ExPolygon::contains_lines(const Lines &lines, std::vector<bool> &retval) const
+{
+    retval.reserve(retval.size() + lines.size());
     
-    Polylines pl_out;
-    diff(pl, *this, pl_out);
-    return pl_out.empty();
+    size_t num_edges = this->contour.points.size();
+    for (Polygons::const_iterator it = this->holes.begin(); it != this->holes.end(); ++it)
+        num_edges += it->points.size();
+    
+    if (lines.size() > 1 && num_edges >= EXPOLYGON_EDGE_INDEX_THRESHOLD) {
+        ExPolygonEdgeIndex index(*this);
+        for (Lines::const_iterator line = lines.begin(); line != lines.end(); ++line)
+            retval.push_back(index.contains_line(*line));
+    } else {
+        for (Lines::const_iterator line = lines.begin(); line != lines.end(); ++line)
+            retval.push_back(this->contains_line(&*line));
+    }
 }
 
 bool
@@ -85,7 +249,8 @@ ExPolygon::contains_point(const Point* point) const
 Polygons
 ExPolygon::simplify_p(double tolerance) const
 {
-    Polygons pp(this->holes.size() + 1);
+    Polygons pp;
+    pp.reserve(this->holes.size() + 1);
     
     // contour
     Polygon p = this->contour;
@@ -119,6 +284,211 @@ ExPolygon::simplify(double tolerance, ExPolygons &expolygons) const
     expolygons.insert(expolygons.end(), ep.begin(), ep.end());
 }
 
+/* Vertices of a ring as sampled for the medial axis: those lying closer than
+   min_length to the previous one are dropped (except the last one), then
+   edges are subdivided so that none of them is longer than min_length. */
+static void
+medial_axis_sites(const Points &ring, double min_length, Points &sites)
+{
+    if (ring.empty()) return;
+    Points points;
+    points.reserve(ring.size());
+    points.push_back(ring.front());
+    for (size_t i = 1; i < ring.size(); ++i) {
+        if (i + 1 == ring.size() || points.back().distance_to(&ring[i]) >= min_length)
+            points.push_back(ring[i]);
+    }
+    
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Point &next = points[(i+1) % points.size()];
+        sites.push_back(points[i]);
+        while (sites.back().distance_to(&next) > min_length) {
+            sites.push_back(Geometry::point_along_segment(
+                Pointf(sites.back().x, sites.back().y), Pointf(next.x, next.y), min_length));
+        }
+    }
+}
+
+/* The medial axis is approximated by the edges of the Voronoi diagram of
+   points sampled along the boundary which lie inside the expolygon. They are
+   chained into polylines starting from the free ends and going straight
+   ahead at junctions; loops, including those reached by such a walk, are
+   returned as polygons. Both are simplified with a tolerance of width/7. */
+void
+ExPolygon::medial_axis(double width, Polylines &polylines, Polygons &polygons) const
+{
+    Points sites;
+    medial_axis_sites(this->contour.points, width/2, sites);
+    for (Polygons::const_iterator it = this->holes.begin(); it != this->holes.end(); ++it)
+        medial_axis_sites(it->points, width/2, sites);
+    
+    Points vertices;
+    std::vector< std::pair<size_t,size_t> > edges;
+    DelaunayTriangulation(sites).voronoi(vertices, edges);
+    
+    Lines lines;
+    lines.reserve(edges.size());
+    for (std::vector< std::pair<size_t,size_t> >::const_iterator it = edges.begin(); it != edges.end(); ++it)
+        lines.push_back(Line(vertices[it->first], vertices[it->second]));
+    std::vector<bool> contained;
+    this->contains_lines(lines, contained);
+    
+    // edges incident to each vertex
+    std::vector< std::vector<size_t> > incident(vertices.size());
+    for (size_t e = 0; e < edges.size(); ++e) {
+        if (!contained[e]) continue;
+        incident[edges[e].first].push_back(e);
+        incident[edges[e].second].push_back(e);
+    }
+    
+    std::vector<bool> visited(edges.size(), false);
+    std::vector<Points> chains;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t v = 0; v < vertices.size(); ++v) {
+            // free ends first, then whatever is left (closed loops)
+            if (pass == 0 && incident[v].size() != 1) continue;
+            for (std::vector<size_t>::const_iterator e = incident[v].begin(); e != incident[v].end(); ++e) {
+                if (visited[*e]) continue;
+                chains.push_back(Points());
+                Points &chain = chains.back();
+                chain.push_back(vertices[v]);
+                size_t from = v, edge = *e;
+                while (edge != (size_t)-1) {
+                    visited[edge] = true;
+                    const size_t to = edges[edge].first == from ? edges[edge].second : edges[edge].first;
+                    chain.push_back(vertices[to]);
+                    
+                    // continue along the edge turning the least
+                    const double dx = vertices[to].x - vertices[from].x, dy = vertices[to].y - vertices[from].y;
+                    double best = -2;
+                    edge = (size_t)-1;
+                    for (std::vector<size_t>::const_iterator n = incident[to].begin(); n != incident[to].end(); ++n) {
+                        if (visited[*n]) continue;
+                        const Point &next = vertices[ edges[*n].first == to ? edges[*n].second : edges[*n].first ];
+                        const double nx = next.x - vertices[to].x, ny = next.y - vertices[to].y;
+                        const double alignment = (dx*nx + dy*ny) / (sqrt(dx*dx + dy*dy) * sqrt(nx*nx + ny*ny));
+                        if (alignment > best) {
+                            best = alignment;
+                            edge = *n;
+                        }
+                    }
+                    from = to;
+                }
+                
+                // a walk ending where it already went through closes a loop:
+                // split it off from the path which led there
+                for (size_t k = 1; k + 1 < chain.size(); ++k) {
+                    if (!chain[k].coincides_with(chain.back())) continue;
+                    Points tail(chain.begin(), chain.begin() + k + 1);
+                    chain.erase(chain.begin(), chain.begin() + k);
+                    chains.push_back(tail);
+                    break;
+                }
+            }
+        }
+    }
+    
+    const double tolerance = width / 7;
+    for (std::vector<Points>::iterator chain = chains.begin(); chain != chains.end(); ++chain) {
+        if (chain->front().coincides_with(chain->back())) {
+            if (chain->size() < 4) continue;
+            Polygon polygon;
+            polygon.points.assign(chain->begin(), chain->end() - 1);
+            polygon.simplify(tolerance, polygons);
+        } else {
+            polylines.push_back(Polyline());
+            polylines.back().points.swap(*chain);
+            polylines.back().simplify(tolerance);
+        }
+    }
+}
+
+ExPolygonEdgeIndex::ExPolygonEdgeIndex(const ExPolygon &expolygon)
+    : min_x(0), max_x(-1), min_y(0), max_y(-1), contour_edges(expolygon.contour.points.size())
+{
+    for (size_t k = 0; k <= expolygon.holes.size(); ++k) {
+        const Points &pp = (k == 0) ? expolygon.contour.points : expolygon.holes[k-1].points;
+        if (pp.empty()) continue;
+        if (this->edges.empty()) {
+            this->min_x = this->max_x = pp.front().x;
+            this->min_y = this->max_y = pp.front().y;
+        }
+        Points::const_iterator j = pp.end() - 1;
+        for (Points::const_iterator i = pp.begin(); i != pp.end(); j = i++) {
+            this->edges.push_back(Line(*j, *i));
+            this->min_x = std::min(this->min_x, i->x);
+            this->max_x = std::max(this->max_x, i->x);
+            this->min_y = std::min(this->min_y, i->y);
+            this->max_y = std::max(this->max_y, i->y);
+        }
+    }
+    
+    // aim at a handful of edges per band
+    size_t num_bands = std::max((size_t)1, this->edges.size() / 4);
+    this->band_height = std::max((coord_t)0, this->max_y - this->min_y) / num_bands + 1;
+    this->bands.resize(num_bands);
+    for (Lines::const_iterator edge = this->edges.begin(); edge != this->edges.end(); ++edge) {
+        size_t last = this->band(std::max(edge->a.y, edge->b.y));
+        for (size_t b = this->band(std::min(edge->a.y, edge->b.y)); b <= last; ++b)
+            this->bands[b].push_back(edge - this->edges.begin());
+    }
+}
+
+size_t
+ExPolygonEdgeIndex::band(coord_t y) const
+{
+    if (y <= this->min_y) return 0;
+    return std::min(this->bands.size() - 1, (size_t)((y - this->min_y) / this->band_height));
+}
+
+/* any edge crossing the ray from (x, y) spans y, hence is listed in its band */
+bool
+ExPolygonEdgeIndex::inside(double x, double y, bool contour_only) const
+{
+    bool inside = false;
+    const std::vector<size_t> &band = this->bands[this->band((coord_t)floor(y))];
+    for (std::vector<size_t>::const_iterator e = band.begin(); e != band.end(); ++e) {
+        if (contour_only && *e >= this->contour_edges) break;  // indices are sorted
+        toggle_if_crossing(x, y, this->edges[*e].a, this->edges[*e].b, inside);
+    }
+    return inside;
+}
+
+bool
+ExPolygonEdgeIndex::contains_point(const Point &point, bool contour_only) const
+{
+    if (point.x < this->min_x || point.x > this->max_x || point.y < this->min_y || point.y > this->max_y)
+        return false;
+    return this->inside(point.x, point.y, contour_only);
+}
+
+bool
+ExPolygonEdgeIndex::contains_line(const Line &line) const
+{
+    // the region lies within its bounding box
+    if (std::min(line.a.x, line.b.x) < this->min_x || std::max(line.a.x, line.b.x) > this->max_x
+        || std::min(line.a.y, line.b.y) < this->min_y || std::max(line.a.y, line.b.y) > this->max_y)
+        return false;
+    if (line.a.coincides_with(line.b)) return this->contains_point(line.a);
+    
+    // edges spanning several bands are visited more than once, which is harmless
+    SegmentProbe probe(line);
+    size_t last = this->band(probe.max_y);
+    for (size_t b = this->band(probe.min_y); b <= last; ++b) {
+        for (std::vector<size_t>::const_iterator e = this->bands[b].begin(); e != this->bands[b].end(); ++e) {
+            if (probe.crosses(this->edges[*e].a, this->edges[*e].b)) return false;
+        }
+    }
+    
+    std::vector<double> midpoints;
+    probe.free_midpoints(midpoints);
+    for (std::vector<double>::const_iterator t = midpoints.begin(); t != midpoints.end(); ++t) {
+        if (!this->inside(line.a.x + (line.b.x - line.a.x) * *t, line.a.y + (line.b.y - line.a.y) * *t, false))
+            return false;
+    }
+    return true;
+}
+
 #ifdef SLIC3RXS
 SV*
 ExPolygon::to_AV() {
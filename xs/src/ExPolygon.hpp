@@ -9,6 +9,9 @@ namespace Slic3r {
 class ExPolygon;
 typedef std::vector<ExPolygon> ExPolygons;
 
+// contains_lines() builds an ExPolygonEdgeIndex above this number of edges
+#define EXPOLYGON_EDGE_INDEX_THRESHOLD 64
+
 class ExPolygon
 {
     public:
@@ -19,12 +22,15 @@ class ExPolygon
     void translate(double x, double y);
     void rotate(double angle, Point* center);
     double area() const;
+    BoundingBox bounding_box() const;
     bool is_valid() const;
     bool contains_line(const Line* line) const;
+    void contains_lines(const Lines &lines, std::vector<bool> &retval) const;
     bool contains_point(const Point* point) const;
     Polygons simplify_p(double tolerance) const;
     ExPolygons simplify(double tolerance) const;
     void simplify(double tolerance, ExPolygons &expolygons) const;
+    void medial_axis(double width, Polylines &polylines, Polygons &polygons) const;
     
     #ifdef SLIC3RXS
     void from_SV(SV* poly_sv);
@@ -36,6 +42,26 @@ class ExPolygon
     #endif
 };
 
+/* Edges of an ExPolygon bucketed in horizontal bands, so that containment
+   tests only visit the edges lying in the bands spanned by the query. Worth
+   building when many lines are tested against an expolygon with many edges. */
+class ExPolygonEdgeIndex
+{
+    public:
+    coord_t min_x, max_x, min_y, max_y;  // bounding box (empty if min > max)
+    explicit ExPolygonEdgeIndex(const ExPolygon &expolygon);
+    bool contains_point(const Point &point, bool contour_only = false) const;
+    bool contains_line(const Line &line) const;
+    
+    private:
+    Lines edges;            // contour edges first, then holes edges
+    size_t contour_edges;
+    coord_t band_height;
+    std::vector< std::vector<size_t> > bands;
+    size_t band(coord_t y) const;
+    bool inside(double x, double y, bool contour_only) const;
+};
+
 }
 
 #endif
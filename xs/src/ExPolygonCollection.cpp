@@ -1,5 +1,7 @@
 #include "ExPolygonCollection.hpp"
+#include "ClipperUtils.hpp"
 #include "Geometry.hpp"
+#include <algorithm>
 
 namespace Slic3r {
 
@@ -49,13 +51,21 @@ ExPolygonCollection::contains_point(const Point* point) const
 }
 
 void
-ExPolygonCollection::simplify(double tolerance)
+ExPolygonCollection::simplify(double tolerance, unsigned int threads_count)
 {
-    ExPolygons expp;
-    for (ExPolygons::const_iterator it = this->expolygons.begin(); it != this->expolygons.end(); ++it) {
-        it->simplify(tolerance, expp);
+    // same as ExPolygon::simplify() on each item, but all the rings of the
+    // collection go through Douglas-Peucker in a single batch
+    ExPolygons simplified = this->expolygons;
+    Geometry::douglas_peucker(simplified, tolerance, threads_count);
+    
+    this->expolygons.clear();
+    for (ExPolygons::const_iterator it = simplified.begin(); it != simplified.end(); ++it) {
+        Polygons pp = *it;
+        simplify_polygons(pp, pp);
+        ExPolygons expp;
+        union_(pp, expp);
+        this->expolygons.insert(this->expolygons.end(), expp.begin(), expp.end());
     }
-    this->expolygons = expp;
 }
 
 void
@@ -67,4 +77,169 @@ ExPolygonCollection::convex_hull(Polygon* hull) const
     Slic3r::Geometry::convex_hull(pp, hull);
 }
 
+BoundingBox
+ExPolygonCollection::bounding_box() const
+{
+    BoundingBox bb;
+    for (ExPolygons::const_iterator it = this->expolygons.begin(); it != this->expolygons.end(); ++it)
+        bb.merge(it->contour.points);
+    return bb;
+}
+
+// number of entries of each R-tree node
+#define EXPOLYGON_INDEX_NODE_SIZE 8
+
+/* an R-tree entry being packed: its bounding box and what it points to */
+struct IndexEntry
+{
+    coord_t min_x, max_x, min_y, max_y;
+    size_t id;
+    double cx() const { return ((double)this->min_x + this->max_x) / 2; };
+    double cy() const { return ((double)this->min_y + this->max_y) / 2; };
+};
+
+static bool
+sort_entries_by_x(const IndexEntry &a, const IndexEntry &b)
+{
+    return a.cx() < b.cx();
+}
+
+static bool
+sort_entries_by_y(const IndexEntry &a, const IndexEntry &b)
+{
+    return a.cy() < b.cy();
+}
+
+/* The tree is built bottom-up with the Sort-Tile-Recursive method: entries are
+   sorted by X into vertical slices, each slice is sorted by Y and cut into
+   nodes, and the nodes become the entries of the level above. */
+ExPolygonCollectionIndex::ExPolygonCollectionIndex(const ExPolygons &expolygons)
+{
+    const size_t M = EXPOLYGON_INDEX_NODE_SIZE;
+    std::vector<IndexEntry> entries;
+    this->islands.reserve(expolygons.size());
+    for (ExPolygons::const_iterator it = expolygons.begin(); it != expolygons.end(); ++it) {
+        this->islands.push_back(ExPolygonEdgeIndex(*it));
+        const ExPolygonEdgeIndex &island = this->islands.back();
+        if (island.min_x > island.max_x) continue;  // empty
+        IndexEntry e = { island.min_x, island.max_x, island.min_y, island.max_y, this->islands.size() - 1 };
+        entries.push_back(e);
+    }
+    
+    bool leaf = true;
+    do {
+        size_t num_nodes  = (entries.size() + M - 1) / M;
+        size_t num_slices = (size_t)ceil(sqrt((double)num_nodes));
+        size_t slice_size = num_slices * M;
+        std::sort(entries.begin(), entries.end(), sort_entries_by_x);
+        for (size_t s = 0; s < entries.size(); s += slice_size)
+            std::sort(entries.begin() + s, entries.begin() + std::min(s + slice_size, entries.size()), sort_entries_by_y);
+        
+        std::vector<IndexEntry> parents;
+        for (size_t s = 0; s < entries.size(); s += slice_size) {
+            size_t slice_end = std::min(s + slice_size, entries.size());
+            for (size_t n = s; n < slice_end; n += M) {
+                Node node;
+                node.first = this->children.size();
+                node.count = std::min(M, slice_end - n);
+                node.leaf  = leaf;
+                node.min_x = entries[n].min_x;
+                node.max_x = entries[n].max_x;
+                node.min_y = entries[n].min_y;
+                node.max_y = entries[n].max_y;
+                for (size_t k = n; k < n + node.count; ++k) {
+                    this->children.push_back(entries[k].id);
+                    node.min_x = std::min(node.min_x, entries[k].min_x);
+                    node.max_x = std::max(node.max_x, entries[k].max_x);
+                    node.min_y = std::min(node.min_y, entries[k].min_y);
+                    node.max_y = std::max(node.max_y, entries[k].max_y);
+                }
+                this->nodes.push_back(node);
+                IndexEntry parent = { node.min_x, node.max_x, node.min_y, node.max_y, this->nodes.size() - 1 };
+                parents.push_back(parent);
+            }
+        }
+        entries = parents;
+        leaf = false;
+    } while (entries.size() > 1);
+}
+
+/* ids of the islands whose bounding box intersects the supplied one, sorted */
+void
+ExPolygonCollectionIndex::candidates(coord_t min_x, coord_t max_x, coord_t min_y, coord_t max_y, std::vector<size_t> &retval) const
+{
+    if (this->nodes.empty()) return;
+    std::vector<size_t> stack(1, this->nodes.size() - 1);
+    while (!stack.empty()) {
+        const Node &node = this->nodes[stack.back()];
+        stack.pop_back();
+        if (node.max_x < min_x || node.min_x > max_x || node.max_y < min_y || node.min_y > max_y)
+            continue;
+        for (size_t k = node.first; k < node.first + node.count; ++k) {
+            if (!node.leaf) {
+                stack.push_back(this->children[k]);
+                continue;
+            }
+            const ExPolygonEdgeIndex &island = this->islands[this->children[k]];
+            if (island.max_x < min_x || island.min_x > max_x || island.max_y < min_y || island.min_y > max_y)
+                continue;
+            retval.push_back(this->children[k]);
+        }
+    }
+    std::sort(retval.begin(), retval.end());
+}
+
+/* index of the first island containing the point, or -1 */
+long
+ExPolygonCollectionIndex::find_point(const Point &point, bool contours_only) const
+{
+    std::vector<size_t> ids;
+    this->candidates(point.x, point.x, point.y, point.y, ids);
+    for (std::vector<size_t>::const_iterator id = ids.begin(); id != ids.end(); ++id) {
+        if (this->islands[*id].contains_point(point, contours_only)) return *id;
+    }
+    return -1;
+}
+
+bool
+ExPolygonCollectionIndex::contains_point(const Point &point) const
+{
+    return this->find_point(point) != -1;
+}
+
+bool
+ExPolygonCollectionIndex::contains_line(const Line &line) const
+{
+    std::vector<size_t> ids;
+    this->candidates(std::min(line.a.x, line.b.x), std::max(line.a.x, line.b.x),
+        std::min(line.a.y, line.b.y), std::max(line.a.y, line.b.y), ids);
+    for (std::vector<size_t>::const_iterator id = ids.begin(); id != ids.end(); ++id) {
+        if (this->islands[*id].contains_line(line)) return true;
+    }
+    return false;
+}
+
+/* whether a single island contains all the lines */
+bool
+ExPolygonCollectionIndex::contains_all_lines(const Lines &lines) const
+{
+    if (lines.empty()) return true;
+    coord_t min_x = lines.front().a.x, max_x = min_x, min_y = lines.front().a.y, max_y = min_y;
+    for (Lines::const_iterator line = lines.begin(); line != lines.end(); ++line) {
+        min_x = std::min(min_x, std::min(line->a.x, line->b.x));
+        max_x = std::max(max_x, std::max(line->a.x, line->b.x));
+        min_y = std::min(min_y, std::min(line->a.y, line->b.y));
+        max_y = std::max(max_y, std::max(line->a.y, line->b.y));
+    }
+    
+    std::vector<size_t> ids;
+    this->candidates(min_x, max_x, min_y, max_y, ids);
+    for (std::vector<size_t>::const_iterator id = ids.begin(); id != ids.end(); ++id) {
+        Lines::const_iterator line = lines.begin();
+        while (line != lines.end() && this->islands[*id].contains_line(*line)) ++line;
+        if (line == lines.end()) return true;
+    }
+    return false;
+}
+
 }
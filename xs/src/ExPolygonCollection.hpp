@@ -15,8 +15,35 @@ class ExPolygonCollection
     void translate(double x, double y);
     void rotate(double angle, Point* center);
     bool contains_point(const Point* point) const;
-    void simplify(double tolerance);
+    void simplify(double tolerance, unsigned int threads_count = 0);
     void convex_hull(Polygon* hull) const;
+    BoundingBox bounding_box() const;
+};
+
+/* Island membership queries for a whole layer: a packed R-tree over the
+   islands' bounding boxes selects the candidates, which are then tested
+   against their own ExPolygonEdgeIndex. Build it once per layer and query it
+   for every extrusion or travel move. */
+class ExPolygonCollectionIndex
+{
+    public:
+    explicit ExPolygonCollectionIndex(const ExPolygons &expolygons);
+    size_t count() const { return this->islands.size(); };
+    long find_point(const Point &point, bool contours_only = false) const;
+    bool contains_point(const Point &point) const;
+    bool contains_line(const Line &line) const;
+    bool contains_all_lines(const Lines &lines) const;
+    
+    private:
+    struct Node {
+        coord_t min_x, max_x, min_y, max_y;
+        size_t first, count;    // range in children
+        bool leaf;              // children are islands rather than nodes
+    };
+    std::vector<ExPolygonEdgeIndex> islands;
+    std::vector<Node> nodes;    // the root is the last one
+    std::vector<size_t> children;
+    void candidates(coord_t min_x, coord_t max_x, coord_t min_y, coord_t max_y, std::vector<size_t> &retval) const;
 };
 
 }
@@ -34,8 +34,8 @@ class ExtrusionEntity
     double height;  // vertical thickness of the extrusion expressed in mm
     double flow_spacing;
     virtual void reverse() = 0;
-    virtual Point* first_point() const = 0;
-    virtual Point* last_point() const = 0;
+    virtual Point first_point() const = 0;
+    virtual Point last_point() const = 0;
     bool is_perimeter() const;
     bool is_fill() const;
     bool is_bridge() const;
@@ -49,8 +49,8 @@ class ExtrusionPath : public ExtrusionEntity
     ExtrusionPath* clone() const;
     Polyline polyline;
     void reverse();
-    Point* first_point() const;
-    Point* last_point() const;
+    Point first_point() const;
+    Point last_point() const;
     ExtrusionEntityCollection* intersect_expolygons(ExPolygonCollection* collection) const;
     ExtrusionEntityCollection* subtract_expolygons(ExPolygonCollection* collection) const;
     void clip_end(double distance);
@@ -69,8 +69,8 @@ class ExtrusionLoop : public ExtrusionEntity
     ExtrusionPath* split_at_first_point() const;
     bool make_counter_clockwise();
     void reverse();
-    Point* first_point() const;
-    Point* last_point() const;
+    Point first_point() const;
+    Point last_point() const;
 };
 
 }
@@ -1,4 +1,5 @@
 #include "ExtrusionEntityCollection.hpp"
+#include "Geometry.hpp"
 
 namespace Slic3r {
 
@@ -21,62 +22,81 @@ ExtrusionEntityCollection::reverse()
     std::reverse(this->entities.begin(), this->entities.end());
 }
 
-Point*
+Point
 ExtrusionEntityCollection::first_point() const
 {
     return this->entities.front()->first_point();
 }
 
-Point*
+Point
 ExtrusionEntityCollection::last_point() const
 {
     return this->entities.back()->last_point();
 }
 
 ExtrusionEntityCollection*
-ExtrusionEntityCollection::chained_path(bool no_reverse) const
+ExtrusionEntityCollection::chained_path(bool no_reverse, bool refine) const
 {
     if (this->entities.empty()) {
         return new ExtrusionEntityCollection ();
     }
-    return this->chained_path_from(this->entities.front()->first_point(), no_reverse);
+    Point start_near = this->entities.front()->first_point();
+    return this->chained_path_from(&start_near, no_reverse, refine);
 }
 
 ExtrusionEntityCollection*
-ExtrusionEntityCollection::chained_path_from(Point* start_near, bool no_reverse) const
+ExtrusionEntityCollection::chained_path_from(Point* start_near, bool no_reverse, bool refine) const
 {
     if (this->no_sort) return this->clone();
     ExtrusionEntityCollection* retval = new ExtrusionEntityCollection;
     
-    ExtrusionEntitiesPtr my_paths;
-    for (ExtrusionEntitiesPtr::const_iterator it = this->entities.begin(); it != this->entities.end(); ++it) {
-        my_paths.push_back((*it)->clone());
-    }
+    retval->entities.reserve(this->entities.size());
     
     Points endpoints;
-    for (ExtrusionEntitiesPtr::iterator it = my_paths.begin(); it != my_paths.end(); ++it) {
-        endpoints.push_back(*(*it)->first_point());
-        if (no_reverse) {
-            endpoints.push_back(*(*it)->first_point());
-        } else {
-            endpoints.push_back(*(*it)->last_point());
-        }
+    this->endpoints(endpoints, no_reverse);
+    NearestPointIndex index(endpoints);
+    
+    // the real endpoints, for walking and refining the path
+    Points ends;
+    if (no_reverse) {
+        this->endpoints(ends, false);
+    } else {
+        ends = endpoints;
     }
     
-    while (!my_paths.empty()) {
+    // path holds the endpoint each item is entered from, in travel order
+    std::vector<size_t> path;
+    path.reserve(ends.size() / 2);
+    Point last_point = *start_near;
+    while (index.size() > 0) {
         // find nearest point
-        int start_index = start_near->nearest_point_index(endpoints);
-        int path_index = start_index/2;
-        if (start_index % 2 && !no_reverse) {
-            my_paths.at(path_index)->reverse();
-        }
-        retval->entities.push_back(my_paths.at(path_index));
-        my_paths.erase(my_paths.begin() + path_index);
-        endpoints.erase(endpoints.begin() + 2*path_index, endpoints.begin() + 2*path_index + 2);
-        start_near = retval->entities.back()->last_point();
+        long start_index = index.nearest(last_point);
+        size_t path_index = start_index/2;
+        path.push_back(no_reverse ? 2*path_index : start_index);
+        index.remove(2*path_index);
+        index.remove(2*path_index + 1);
+        last_point = ends[ path.back() ^ 1 ];
+    }
+    if (refine) Geometry::refine_chained_path(*start_near, ends, path, no_reverse);
+    
+    for (std::vector<size_t>::const_iterator it = path.begin(); it != path.end(); ++it) {
+        retval->entities.push_back(this->entities[*it / 2]->clone());
+        if (*it % 2) retval->entities.back()->reverse();
     }
     
     return retval;
 }
 
+/* appends the first and last point of each entity to retval, in order;
+   when no_reverse is true the first point is repeated instead of the last one */
+void
+ExtrusionEntityCollection::endpoints(Points &retval, bool no_reverse) const
+{
+    retval.reserve(retval.size() + 2 * this->entities.size());
+    for (ExtrusionEntitiesPtr::const_iterator it = this->entities.begin(); it != this->entities.end(); ++it) {
+        retval.push_back((*it)->first_point());
+        retval.push_back(no_reverse ? (*it)->first_point() : (*it)->last_point());
+    }
+}
+
 }
@@ -13,11 +13,12 @@ class ExtrusionEntityCollection : public ExtrusionEntity
     ExtrusionEntitiesPtr entities;
     bool no_sort;
     ExtrusionEntityCollection(): no_sort(false) {};
-    ExtrusionEntityCollection* chained_path(bool no_reverse) const;
-    ExtrusionEntityCollection* chained_path_from(Point* start_near, bool no_reverse) const;
+    ExtrusionEntityCollection* chained_path(bool no_reverse, bool refine = false) const;
+    ExtrusionEntityCollection* chained_path_from(Point* start_near, bool no_reverse, bool refine = false) const;
     void reverse();
-    Point* first_point() const;
-    Point* last_point() const;
+    Point first_point() const;
+    Point last_point() const;
+    void endpoints(Points &retval, bool no_reverse = false) const;
 };
 
 }
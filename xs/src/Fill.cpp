@@ -0,0 +1,858 @@
+#include "Fill.hpp"
+#include "BoundingBox.hpp"
+#include "ClipperUtils.hpp"
+#include "Parallel.hpp"
+#include "PolylineCollection.hpp"
+#include <algorithm>
+#include <cmath>
+#include <list>
+
+namespace Slic3r {
+
+namespace Fill {
+
+/* Infill already computed for a surface: the result only depends on the
+   surface, the spacing, the density and the flags. Entries are kept until
+   the thread moves on to another layer (see cache_clear()). */
+struct CacheEntry
+{
+    size_t hash;
+    ExPolygon expolygon;
+    double min_spacing;
+    double density;
+    int flags;
+    double line_spacing;
+    Polylines polylines;
+};
+
+typedef std::list<CacheEntry> Cache;  // most recently used first
+
+static ThreadCounter cache_hits;
+static ThreadCounter cache_misses;
+static ThreadCounter pattern_cache_hits;    // of the honeycomb pattern cache below
+static ThreadCounter pattern_cache_misses;
+static ThreadLocal<Cache> thread_cache;
+
+static size_t
+cache_hash(const ExPolygon &expolygon, double min_spacing, double density, int flags)
+{
+    // FNV-1a over the coordinates, with the number of points closing each ring
+    size_t h = 2166136261u;
+    Polygons pp = expolygon;
+    for (Polygons::const_iterator p = pp.begin(); p != pp.end(); ++p) {
+        for (Points::const_iterator pt = p->points.begin(); pt != p->points.end(); ++pt) {
+            h = (h ^ (size_t)pt->x) * 16777619u;
+            h = (h ^ (size_t)pt->y) * 16777619u;
+        }
+        h = (h ^ p->points.size()) * 16777619u;
+    }
+    h = (h ^ (size_t)min_spacing) * 16777619u;
+    h = (h ^ (size_t)(density * 1000000)) * 16777619u;
+    return (h ^ (size_t)flags) * 16777619u;
+}
+
+static bool
+same_points(const Points &a, const Points &b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!a[i].coincides_with(b[i])) return false;
+    }
+    return true;
+}
+
+static bool
+same_expolygon(const ExPolygon &a, const ExPolygon &b)
+{
+    if (a.holes.size() != b.holes.size() || !same_points(a.contour.points, b.contour.points))
+        return false;
+    for (size_t i = 0; i < a.holes.size(); ++i) {
+        if (!same_points(a.holes[i].points, b.holes[i].points)) return false;
+    }
+    return true;
+}
+
+static const CacheEntry*
+cache_lookup(size_t hash, const ExPolygon &expolygon, double min_spacing, double density, int flags)
+{
+    Cache &cache = *thread_cache.get();
+    Cache::iterator it = cache.begin();
+    for (; it != cache.end(); ++it) {
+        if (it->hash == hash && it->min_spacing == min_spacing && it->density == density
+            && it->flags == flags && same_expolygon(it->expolygon, expolygon))
+            break;
+    }
+    if (it == cache.end()) {
+        cache_misses.increment();
+        return NULL;
+    }
+    cache.splice(cache.begin(), cache, it);
+    cache_hits.increment();
+    return &cache.front();
+}
+
+static void
+cache_store(const CacheEntry &entry)
+{
+    Cache &cache = *thread_cache.get();
+    cache.push_front(entry);
+    if (cache.size() > FILL_CACHE_CAPACITY) cache.pop_back();
+}
+
+void
+cache_clear()
+{
+    thread_cache.get()->clear();
+}
+
+void
+cache_stats(size_t &hits, size_t &misses, size_t &pattern_hits, size_t &pattern_misses)
+{
+    hits           = cache_hits.sum();
+    misses         = cache_misses.sum();
+    pattern_hits   = pattern_cache_hits.sum();
+    pattern_misses = pattern_cache_misses.sum();
+}
+
+/* Honeycomb columns already generated for a window of the pattern. Unlike
+   the infill cache these are shared by all threads, since every layer of a
+   part usually needs the same window whatever the shape of its surfaces. */
+struct PatternEntry
+{
+    double min_spacing;
+    double density;
+    double angle;
+    BoundingBox window;  // aligned, in the frame rotated by angle
+    Polygons columns;    // rotated back
+};
+
+typedef std::list<PatternEntry> PatternCache;  // most recently used first
+
+static Mutex pattern_mutex;
+static PatternCache pattern_cache;
+
+static bool
+pattern_lookup(double min_spacing, double density, double angle, const BoundingBox &window, Polygons &columns)
+{
+    MutexLock lock(pattern_mutex);
+    PatternCache::iterator it = pattern_cache.begin();
+    for (; it != pattern_cache.end(); ++it) {
+        if (it->min_spacing == min_spacing && it->density == density && it->angle == angle
+            && it->window.min.coincides_with(window.min) && it->window.max.coincides_with(window.max))
+            break;
+    }
+    if (it == pattern_cache.end()) {
+        pattern_cache_misses.increment();
+        return false;
+    }
+    pattern_cache.splice(pattern_cache.begin(), pattern_cache, it);
+    columns = it->columns;
+    pattern_cache_hits.increment();
+    return true;
+}
+
+static void
+pattern_store(const PatternEntry &entry)
+{
+    MutexLock lock(pattern_mutex);
+    pattern_cache.push_front(entry);
+    if (pattern_cache.size() > HONEYCOMB_CACHE_CAPACITY) pattern_cache.pop_back();
+}
+
+/* a test line from its top point down to its bottom point */
+struct ScanLine
+{
+    Point top, bottom;
+    std::vector<double> crossings;  // where edges cross it, 0 at the bottom and 1 at the top
+};
+
+/* Finds where the polygon edges cross the scanlines, which are ordered by x
+   with line k lying within slack of x0 + k * spacing. Each edge only visits
+   the lines spanning its own x range, instead of every line being clipped
+   against every edge. Edges touching a line are counted on one side only,
+   so that crossings come in pairs along each line. */
+static void
+scanline_crossings(const Polygons &polygons, double x0, double spacing, coord_t slack,
+    std::vector<ScanLine> &lines)
+{
+    if (lines.empty()) return;
+    const long last = lines.size() - 1;
+    for (Polygons::const_iterator polygon = polygons.begin(); polygon != polygons.end(); ++polygon) {
+        const Points &pts = polygon->points;
+        for (size_t i = 0; i < pts.size(); ++i) {
+            const Point &p = pts[i], &q = pts[(i + 1) % pts.size()];
+            const long k0 = std::max(0L, (long)ceil((std::min(p.x, q.x) - slack - x0) / spacing));
+            const long k1 = std::min(last, (long)floor((std::max(p.x, q.x) + slack - x0) / spacing));
+            for (long k = k0; k <= k1; ++k) {
+                ScanLine &line = lines[k];
+                const coord2_t dx = (coord2_t)line.top.x - line.bottom.x;
+                const coord2_t dy = (coord2_t)line.top.y - line.bottom.y;
+                const coord2_t side_p = dx * (p.y - line.bottom.y) - dy * (p.x - line.bottom.x);
+                const coord2_t side_q = dx * (q.y - line.bottom.y) - dy * (q.x - line.bottom.x);
+                if ((side_p > 0) == (side_q > 0)) continue;
+    
+                const coord2_t wx = (coord2_t)q.x - p.x, wy = (coord2_t)q.y - p.y;
+                const coord2_t num = ((coord2_t)p.x - line.bottom.x) * wy - ((coord2_t)p.y - line.bottom.y) * wx;
+                line.crossings.push_back((double)num / (double)(dx * wy - dy * wx));
+            }
+        }
+    }
+}
+
+/* Solid infill spacing is stretched so that lines run from one side of the
+   surface to the other. Integer remainder as in Perl's % operator. */
+static double
+adjust_solid_spacing(coord_t width, double distance)
+{
+    const long number_of_lines = (long)(width / distance) + 1;
+    if (number_of_lines <= 1) return distance;
+    
+    const coord_t extra_space = width % (coord_t)distance;
+    return distance + (double)extra_space / (number_of_lines - 1);
+}
+
+/* Levels of the offset ladder computed from the outermost loops: level k is
+   the outermost loops shrunk by k * distance (then opened like the
+   incremental levels), so all levels can be computed in parallel. */
+class ConcentricLadderJob : public ParallelJob
+{
+    public:
+    const Polygons &outermost;
+    double distance;
+    std::vector<ExPolygons> levels;
+    ConcentricLadderJob(const Polygons &_outermost, double _distance, size_t count)
+        : outermost(_outermost), distance(_distance), levels(count) {};
+    void run(size_t idx)
+    {
+        offset2_ex(this->outermost, this->levels[idx], -(idx + 1.5) * this->distance, +0.5 * this->distance);
+    };
+};
+
+/* Loops of the ladder are nested: each expolygon of a level lies within a
+   single expolygon of the previous level. */
+struct ConcentricLadder
+{
+    std::vector<ExPolygons> levels;
+    std::vector< std::vector< std::vector<size_t> > > children;  // indices in the next level
+    double clip_length;
+};
+
+/* index of the loop having the point nearest to pos */
+static size_t
+nearest_loop(const std::vector<Polygon*> &loops, const Point &pos)
+{
+    size_t nearest = 0;
+    double min_dist = -1;
+    for (size_t i = 0; i < loops.size(); ++i) {
+        const Point &p = loops[i]->points[pos.nearest_point_index(loops[i]->points)];
+        const double dist = pos.distance_to(&p);
+        if (min_dist < 0 || dist < min_dist) {
+            nearest = i;
+            min_dist = dist;
+        }
+    }
+    return nearest;
+}
+
+static void
+concentric_loop(Polygon &loop, const ConcentricLadder &ladder, Point &last_pos, Polylines &retval)
+{
+    // split by value, as deleting through the Polyline* of split_at_index()
+    // would hit the non virtual destructor of MultiPoint
+    const Points::iterator split = loop.points.begin() + last_pos.nearest_point_index(loop.points);
+    retval.push_back(Polyline());
+    Polyline &path = retval.back();
+    path.points.reserve(loop.points.size() + 1);
+    path.points.insert(path.points.end(), split, loop.points.end());
+    path.points.insert(path.points.end(), loop.points.begin(), split + 1);
+    last_pos = path.last_point();
+    path.clip_end(ladder.clip_length);
+}
+
+/* Emits the contour of an expolygon, then the expolygons nested within it
+   and finally its holes, so that loops go from the outside in and the holes
+   loops from the middle of the material back to the holes; the loops of
+   each step are ordered using a nearest neighbor search. */
+static void
+concentric_chain(size_t level, size_t idx, ConcentricLadder &ladder, Point &last_pos, Polylines &retval)
+{
+    ExPolygon &expolygon = ladder.levels[level][idx];
+    concentric_loop(expolygon.contour, ladder, last_pos, retval);
+    
+    std::vector<size_t> children = ladder.children[level][idx];
+    while (!children.empty()) {
+        std::vector<Polygon*> contours;
+        for (std::vector<size_t>::const_iterator c = children.begin(); c != children.end(); ++c)
+            contours.push_back(&ladder.levels[level + 1][*c].contour);
+        const size_t next = nearest_loop(contours, last_pos);
+        const size_t child = children[next];
+        children.erase(children.begin() + next);
+        concentric_chain(level + 1, child, ladder, last_pos, retval);
+    }
+    
+    Polygons holes = expolygon.holes;
+    while (!holes.empty()) {
+        std::vector<Polygon*> loops;
+        for (Polygons::iterator hole = holes.begin(); hole != holes.end(); ++hole)
+            loops.push_back(&*hole);
+        const size_t next = nearest_loop(loops, last_pos);
+        Polygon hole = holes[next];
+        holes.erase(holes.begin() + next);
+        hole.reverse();  // ccw like the contours
+        concentric_loop(hole, ladder, last_pos, retval);
+    }
+}
+
+/* Rectilinear infill of an expolygon already rotated so that the lines run
+   vertically, one line every min_spacing / density. Solid infill (density 1)
+   stretches the spacing to fit the surface width unless dont_adjust is set;
+   otherwise lines are aligned to multiples of the spacing so that they line
+   up across layers. Every other line of the line pattern is slanted by the
+   extra spacing. Lines are clipped by a scanline pass over the edges of the
+   expolygon (slightly grown, so that lines running along vertical sides are
+   kept), then chained and joined into zig-zags whenever the connection is
+   short and stays within the surface, unless dont_connect is set.
+   Surfaces unlikely to repeat across layers (such as gaps) can skip the
+   infill cache by unsetting cached, so that they don't evict the entries
+   of the layer's regular surfaces nor count as misses.
+   Returns the line spacing, which callers use as the actual flow spacing of
+   solid infill. */
+double
+rectilinear(const ExPolygon &expolygon, double min_spacing, double density,
+    bool is_line_pattern, bool dont_adjust, bool dont_connect, Polylines &retval, bool cached)
+{
+    const int flags = (is_line_pattern ? 1 : 0) | (dont_adjust ? 2 : 0) | (dont_connect ? 4 : 0);
+    const size_t hash = cached ? cache_hash(expolygon, min_spacing, density, flags) : 0;
+    if (cached) {
+        if (const CacheEntry* entry = cache_lookup(hash, expolygon, min_spacing, density, flags)) {
+            retval.insert(retval.end(), entry->polylines.begin(), entry->polylines.end());
+            return entry->line_spacing;
+        }
+    }
+    
+    const coord_t scaled_epsilon = scale_(EPSILON);
+    double line_spacing = min_spacing / density;
+    const double line_oscillation = line_spacing - min_spacing;
+    BoundingBox bb = expolygon.bounding_box();
+    
+    if (density == 1 && !dont_adjust) {
+        line_spacing = adjust_solid_spacing(bb.max.x - bb.min.x, line_spacing);
+    } else {
+        // extend bounding box so that our pattern will be aligned with other layers
+        const coord_t step = (coord_t)line_spacing;
+        bb.min.x -= ((bb.min.x % step) + step) % step;
+        bb.min.y -= ((bb.min.y % step) + step) % step;
+    }
+    
+    // generate the basic pattern
+    std::vector<ScanLine> lines;
+    size_t i = 0;
+    for (double x = bb.min.x; x <= bb.max.x + scaled_epsilon; x += line_spacing, ++i) {
+        ScanLine line;
+        line.top    = Point((coord_t)lrint(x), bb.max.y);
+        line.bottom = Point((coord_t)lrint(x), bb.min.y);
+        if (is_line_pattern && i % 2) {
+            line.top.x    = (coord_t)lrint(x + line_oscillation);
+            line.bottom.x = (coord_t)lrint(x - line_oscillation);
+        }
+        lines.push_back(line);
+    }
+    
+    /* clip paths against a slightly offsetted expolygon, so that the first
+       and last paths are kept even if the expolygon has vertical sides;
+       the minimum offset for preventing edge lines from being clipped is
+       scaled_epsilon, however we use a larger offset to support expolygons
+       with slightly skewed sides and not perfectly straight */
+    Polygons clip_area;
+    offset((Polygons)expolygon, clip_area, line_spacing * 0.05);
+    scanline_crossings(clip_area, bb.min.x, line_spacing, (coord_t)ceil(line_oscillation) + 2, lines);
+    
+    Polylines polylines;
+    for (std::vector<ScanLine>::iterator line = lines.begin(); line != lines.end(); ++line) {
+        std::sort(line->crossings.begin(), line->crossings.end());
+        const double dx = (double)line->top.x - line->bottom.x, dy = (double)line->top.y - line->bottom.y;
+        // inside parts, from the top down
+        for (size_t c = line->crossings.size() / 2 * 2; c >= 2; c -= 2) {
+            const double from = std::min(1.0, line->crossings[c-1]), to = std::max(0.0, line->crossings[c-2]);
+            if (from <= to) continue;
+            Polyline polyline;
+            polyline.points.push_back(Point((coord_t)lrint(line->bottom.x + from * dx), (coord_t)lrint(line->bottom.y + from * dy)));
+            polyline.points.push_back(Point((coord_t)lrint(line->bottom.x + to * dx), (coord_t)lrint(line->bottom.y + to * dy)));
+            if (!polyline.points.front().coincides_with(polyline.points.back())) polylines.push_back(polyline);
+        }
+    }
+    
+    // connect lines
+    const size_t first = retval.size();
+    if (!dont_connect && !polylines.empty()) {
+        ExPolygons expolygons_off;
+        offset_ex((Polygons)expolygon, expolygons_off, min_spacing / 2);
+    
+        PolylineCollection collection;
+        collection.polylines.swap(polylines);
+        Point* start_near = collection.leftmost_point();
+        PolylineCollection* chained = collection.chained_path_from(start_near, false);
+        delete start_near;
+    
+        // each connection joins the end of a path to the start of the next one
+        Lines connections;
+        for (Polylines::const_iterator it = chained->polylines.begin() + 1; it != chained->polylines.end(); ++it)
+            connections.push_back(Line((it - 1)->last_point(), it->first_point()));
+        std::vector<bool> contained;
+        if (!expolygons_off.empty()) expolygons_off.front().contains_lines(connections, contained);
+    
+        const double tolerance = 10 * scaled_epsilon;
+        const double diagonal_distance = line_spacing * 2;
+        for (Polylines::const_iterator it = chained->polylines.begin(); it != chained->polylines.end(); ++it) {
+            if (it != chained->polylines.begin() && !contained.empty()) {
+                const Line &connection = connections[it - chained->polylines.begin() - 1];
+                const double distance_x = std::abs(connection.b.x - connection.a.x);
+                const double distance_y = std::abs(connection.b.y - connection.a.y);
+                const bool can_connect = is_line_pattern
+                    ? distance_x >= (line_spacing - line_oscillation) - tolerance
+                        && distance_x <= (line_spacing + line_oscillation) + tolerance
+                        && distance_y <= diagonal_distance
+                    : distance_x <= diagonal_distance && distance_y <= diagonal_distance;
+    
+                // TODO: we should also check that both points are on a fill_boundary to avoid
+                // connecting paths on the boundaries of internal regions
+                if (can_connect && contained[it - chained->polylines.begin() - 1]) {
+                    retval.back().points.insert(retval.back().points.end(), it->points.begin(), it->points.end());
+                    continue;
+                }
+            }
+            retval.push_back(*it);
+        }
+        delete chained;
+    } else {
+        retval.insert(retval.end(), polylines.begin(), polylines.end());
+    }
+    if (!cached) return line_spacing;
+    
+    CacheEntry entry;
+    entry.hash          = hash;
+    entry.expolygon     = expolygon;
+    entry.min_spacing   = min_spacing;
+    entry.density       = density;
+    entry.flags         = flags;
+    entry.line_spacing  = line_spacing;
+    entry.polylines.assign(retval.begin() + first, retval.end());
+    cache_store(entry);
+    
+    return line_spacing;
+}
+
+/* Concentric infill: loops inset by distance = min_spacing / density from
+   each other, starting from the outline (whose offset compensates the
+   infill overlap, which is harmful here as loop spacing should be equal to
+   any other loop spacing) until nothing is left. Solid infill spacing is
+   stretched to fit the surface width unless dont_adjust is set. With
+   incremental set each level is offset from the previous one; otherwise
+   levels are offset from the outermost loops, in parallel on up to
+   threads_count threads (0 means one per core), so that offset errors don't
+   accumulate, but each of them costs as much as offsetting the outline
+   (which is a lot on detailed outlines). Loops are returned from
+   the outermost to the innermost (so that the first central tiny loops
+   don't have adhesion problems), following the nesting of the levels
+   instead of a union of all loops, each split at the point nearest to the
+   end of the previous one and clipped at its end so that the extruder
+   doesn't get exactly on its first point. Returns the loop spacing, which
+   callers use as the actual flow spacing of solid infill. */
+double
+concentric(const ExPolygon &expolygon, double min_spacing, double density,
+    bool dont_adjust, bool incremental, Polylines &retval, unsigned int threads_count)
+{
+    double distance = min_spacing / density;
+    bool adjusted = false;
+    if (density == 1 && !dont_adjust) {
+        const BoundingBox bb = expolygon.bounding_box();
+        distance = adjust_solid_spacing(bb.max.x - bb.min.x, distance);
+        adjusted = true;
+    }
+    
+    ConcentricLadder ladder;
+    ladder.clip_length = (adjusted ? distance : min_spacing) * LOOP_CLIPPING_LENGTH_OVER_SPACING;
+    ladder.levels.push_back(ExPolygons());
+    offset_ex((Polygons)expolygon, ladder.levels.back(), -INFILL_OVERLAP_OVER_SPACING * min_spacing / 2);
+    if (incremental) {
+        while (!ladder.levels.back().empty()) {
+            Polygons last;
+            for (ExPolygons::const_iterator it = ladder.levels.back().begin(); it != ladder.levels.back().end(); ++it) {
+                Polygons pp = *it;
+                last.insert(last.end(), pp.begin(), pp.end());
+            }
+            ladder.levels.push_back(ExPolygons());
+            offset2_ex(last, ladder.levels.back(), -1.5 * distance, +0.5 * distance);
+        }
+        // drop the trailing empty level, unless the surface vanished under
+        // the overlap offset and it is the only one
+        if (ladder.levels.size() > 1) ladder.levels.pop_back();
+    } else if (!ladder.levels.back().empty()) {
+        // no level is left beyond half the smallest side of the bounding box
+        const BoundingBox bb = expolygon.bounding_box();
+        const size_t count = (size_t)(std::min(bb.max.x - bb.min.x, bb.max.y - bb.min.y) / distance / 2) + 1;
+        Polygons outermost;
+        for (ExPolygons::const_iterator it = ladder.levels.back().begin(); it != ladder.levels.back().end(); ++it) {
+            Polygons pp = *it;
+            outermost.insert(outermost.end(), pp.begin(), pp.end());
+        }
+        ConcentricLadderJob job(outermost, distance, count);
+        parallelize(job, count, threads_count);
+        for (std::vector<ExPolygons>::iterator level = job.levels.begin(); level != job.levels.end() && !level->empty(); ++level) {
+            ladder.levels.push_back(ExPolygons());
+            ladder.levels.back().swap(*level);
+        }
+    }
+    
+    // nest each level within the previous one
+    ladder.children.resize(ladder.levels.size());
+    for (size_t level = 0; level < ladder.levels.size(); ++level) {
+        ladder.children[level].resize(ladder.levels[level].size());
+        if (level == 0) continue;
+        const ExPolygons &parents = ladder.levels[level - 1];
+        for (size_t i = 0; i < ladder.levels[level].size(); ++i) {
+            const Point &p = ladder.levels[level][i].contour.points.front();
+            size_t parent = 0;
+            while (parent + 1 < parents.size() && !parents[parent].contains_point(&p)) ++parent;
+            ladder.children[level - 1][parent].push_back(i);
+        }
+    }
+    
+    // generate paths from the outermost to the innermost, to avoid
+    // adhesion problems of the first central tiny loops
+    Point last_pos(0,0);
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < ladder.levels.front().size(); ++i) roots.push_back(i);
+    while (!roots.empty()) {
+        std::vector<Polygon*> contours;
+        for (std::vector<size_t>::const_iterator r = roots.begin(); r != roots.end(); ++r)
+            contours.push_back(&ladder.levels.front()[*r].contour);
+        const size_t next = nearest_loop(contours, last_pos);
+        const size_t root = roots[next];
+        roots.erase(roots.begin() + next);
+        concentric_chain(0, root, ladder, last_pos, retval);
+    }
+    
+    return distance;
+}
+
+/* Honeycomb infill: columns of half hexagons, one every min_spacing / density,
+   laid over the bounding box of the expolygon rotated by angle around the
+   hexagon center and aligned to the pattern so that it matches across
+   layers. Each column is the closed loop of two mirrored zig-zags; the
+   columns of a window are shared by all threads and layers. With complete
+   set the loops are clipped as areas and returned closed; otherwise they are
+   clipped as open zig-zags (so that the jump to the next path is straighter),
+   chained and joined when the next path starts within a hexagon width, then
+   clipped again so that joints can't leave the surface. */
+void
+honeycomb(const ExPolygon &expolygon, double min_spacing, double density, double angle,
+    bool complete, Polylines &retval)
+{
+    // hexagons math
+    const double distance       = min_spacing / density;
+    const double hex_side       = distance / (sqrt(3.0)/2);
+    const double hex_width      = distance * 2;  // hex_width == hex_side * sqrt(3)
+    const double hex_height     = hex_side * 2;
+    const double pattern_height = hex_height + hex_side;
+    const double y_short        = distance * sqrt(3.0)/3;
+    const double x_offset       = min_spacing / 2;
+    const double y_offset       = x_offset * sqrt(3.0)/3;
+    Point hex_center((coord_t)(hex_width/2), (coord_t)hex_side);
+    
+    // adjust actual bounding box to the nearest multiple of our hex pattern
+    // and align it so that it matches across layers
+    Polygon bb_polygon;
+    expolygon.bounding_box().polygon(&bb_polygon);
+    bb_polygon.rotate(angle, &hex_center);
+    BoundingBox bb = bb_polygon.bounding_box();
+    {
+        // integer remainders as in Perl's % operator
+        const coord_t step_x = (coord_t)hex_width, step_y = (coord_t)pattern_height;
+        bb.min.x -= ((bb.min.x % step_x) + step_x) % step_x;
+        bb.min.y -= ((bb.min.y % step_y) + step_y) % step_y;
+    }
+    
+    Polygons columns;
+    if (!pattern_lookup(min_spacing, density, angle, bb, columns)) {
+        for (double x = bb.min.x; x <= bb.max.x; ) {
+            Polygon column;
+            double x0 = x + x_offset, x1 = x + distance - x_offset;
+            for (int half = 0; half < 2; ++half) {
+                std::reverse(column.points.begin(), column.points.end());  // turn first half upside down
+                for (double y = bb.min.y; y <= bb.max.y; y += y_short + hex_side + y_short + hex_side) {
+                    column.points.push_back(Point((coord_t)lrint(x1), (coord_t)lrint(y + y_offset)));
+                    column.points.push_back(Point((coord_t)lrint(x0), (coord_t)lrint(y + y_short - y_offset)));
+                    column.points.push_back(Point((coord_t)lrint(x0), (coord_t)lrint(y + y_short + hex_side + y_offset)));
+                    column.points.push_back(Point((coord_t)lrint(x1), (coord_t)lrint(y + y_short + hex_side + y_short - y_offset)));
+                    column.points.push_back(Point((coord_t)lrint(x1), (coord_t)lrint(y + y_short + hex_side + y_short + hex_side + y_offset)));
+                }
+                // draw symmetrical pattern
+                const double next_x0 = x1 + distance;
+                x1 = x0 + distance;
+                x0 = next_x0;
+                x += distance;
+            }
+            column.rotate(-angle, &hex_center);
+            columns.push_back(column);
+        }
+        
+        PatternEntry entry;
+        entry.min_spacing   = min_spacing;
+        entry.density       = density;
+        entry.angle         = angle;
+        entry.window        = bb;
+        entry.columns       = columns;
+        pattern_store(entry);
+    }
+    
+    if (complete) {
+        // we were requested to complete each loop;
+        // in this case we don't try to make more continuous paths
+        Polygons loops;
+        intersection((Polygons)expolygon, columns, loops, false);
+        for (Polygons::const_iterator loop = loops.begin(); loop != loops.end(); ++loop) {
+            retval.push_back(Polyline());
+            retval.back().points = loop->points;
+            retval.back().points.push_back(loop->points.front());
+        }
+        return;
+    }
+    
+    // consider polygons as polylines without re-appending the initial point:
+    // this cuts the last segment on purpose, so that the jump to the next
+    // path is more straight
+    Polylines zigzags;
+    for (Polygons::const_iterator column = columns.begin(); column != columns.end(); ++column) {
+        Polyline zigzag;
+        zigzag.points = column->points;
+        zigzags.push_back(zigzag);
+    }
+    PolylineCollection collection;
+    intersection(zigzags, (Polygons)expolygon, collection.polylines);
+    if (collection.polylines.empty()) return;
+    
+    // connect paths
+    Point* start_near = collection.leftmost_point();
+    PolylineCollection* chained = collection.chained_path_from(start_near, false);
+    delete start_near;
+    Polylines paths;
+    for (Polylines::const_iterator it = chained->polylines.begin(); it != chained->polylines.end(); ++it) {
+        const Point first_point = it->first_point();
+        if (!paths.empty() && paths.back().last_point().distance_to(&first_point) <= hex_width) {
+            paths.back().points.insert(paths.back().points.end(), it->points.begin(), it->points.end());
+            continue;
+        }
+        paths.push_back(*it);
+    }
+    delete chained;
+    
+    // clip paths again to prevent connection segments from crossing the expolygon boundaries
+    Polygons clip_area;
+    offset((Polygons)expolygon, clip_area, scale_(EPSILON));
+    Polylines clipped;
+    intersection(paths, clip_area, clipped);
+    retval.insert(retval.end(), clipped.begin(), clipped.end());
+}
+
+/* Points of a curve lying within a box, collected as runs of consecutive
+   points: the curve is cut wherever it leaves the box. Curves are laid in
+   units of distance, so the box is the bounding box of the surface in these
+   units, grown by the longest step of the curve so that each step crossing
+   the surface has both its ends in the box. */
+class CurveRuns
+{
+    public:
+    double min_x, min_y, max_x, max_y;
+    double distance;
+    Polylines runs;
+    CurveRuns(const BoundingBox &bb, double _distance, double step)
+        : min_x(bb.min.x / _distance - step), min_y(bb.min.y / _distance - step),
+          max_x(bb.max.x / _distance + step), max_y(bb.max.y / _distance + step),
+          distance(_distance), _cut(true) {};
+    bool contains(double x, double y) const
+    {
+        return x >= this->min_x && x <= this->max_x && y >= this->min_y && y <= this->max_y;
+    };
+    void add(double x, double y)
+    {
+        if (!this->contains(x, y)) {
+            this->cut();
+            return;
+        }
+        if (this->_cut) {
+            if (!this->runs.empty() && this->runs.back().points.size() < 2) this->runs.pop_back();
+            this->runs.push_back(Polyline());
+            this->_cut = false;
+        }
+        this->runs.back().points.push_back(Point((coord_t)lrint(x * this->distance), (coord_t)lrint(y * this->distance)));
+    };
+    void cut() { this->_cut = true; };
+    void finish()
+    {
+        if (!this->runs.empty() && this->runs.back().points.size() < 2) this->runs.pop_back();
+    };
+    
+    private:
+    bool _cut;
+};
+
+/* Point d of the Hilbert curve filling a side x side square (side being a
+   power of 4, so that the curve starts like every larger one, going from
+   (0,0) to (1,0), as in Math::PlanePath::HilbertCurve). */
+static void
+hilbert_d2xy(unsigned long side, unsigned long d, unsigned long &x, unsigned long &y)
+{
+    x = y = 0;
+    for (unsigned long s = 1; s < side; s *= 2, d /= 4) {
+        const unsigned long rx = 1 & (d / 2);
+        const unsigned long ry = 1 & (d ^ rx);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+        x += s * rx;
+        y += s * ry;
+    }
+}
+
+/* Visits the points d0 .. d0 + 4^level - 1 of the curve, which fill a
+   2^level square, skipping the squares lying outside the box. */
+static void
+hilbert_visit(unsigned long side, unsigned long d0, unsigned int level, CurveRuns &runs)
+{
+    unsigned long x, y;
+    hilbert_d2xy(side, d0, x, y);
+    if (level == 0) {
+        runs.add(x, y);
+        return;
+    }
+    const unsigned long size = 1UL << level;
+    x -= x % size;
+    y -= y % size;
+    if (x > runs.max_x || y > runs.max_y || x + size - 1 < runs.min_x || y + size - 1 < runs.min_y) {
+        runs.cut();
+        return;
+    }
+    const unsigned long quarter = 1UL << (2 * (level - 1));
+    for (unsigned long q = 0; q < 4; ++q)
+        hilbert_visit(side, d0 + q * quarter, level - 1, runs);
+}
+
+/* The Hilbert curve covering the first quadrant, with unit steps. */
+static void
+hilbert_curve(CurveRuns &runs)
+{
+    if (runs.max_x < 0 || runs.max_y < 0) return;
+    unsigned int level = 0;
+    while ((double)(1UL << level) <= std::max(runs.max_x, runs.max_y)) level += 2;
+    hilbert_visit(1UL << level, 0, level, runs);
+}
+
+/* The Archimedean spiral r = theta / 2PI around the origin (one turn per
+   unit of radius), sampled with unit chords as Math::PlanePath's
+   ArchimedeanChords: the first point is the origin and the second one is
+   (1,0), then each point is found by Newton's method from the previous one.
+   Points are generated until the spiral is past the box. */
+static void
+archimedean_chords(CurveRuns &runs)
+{
+    double r_max = 0;
+    const double xs[2] = { runs.min_x, runs.max_x }, ys[2] = { runs.min_y, runs.max_y };
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j)
+            r_max = std::max(r_max, sqrt(xs[i] * xs[i] + ys[j] * ys[j]));
+    }
+    
+    runs.add(0, 0);
+    double theta = 2 * PI, x = 1, y = 0;
+    while (theta / (2 * PI) <= r_max + 1) {
+        runs.add(x, y);
+        
+        // the arc length is about r dtheta
+        double next = theta + 1 / (theta / (2 * PI));
+        for (int i = 0; i < 20; ++i) {
+            const double r = next / (2 * PI), c = cos(next), s = sin(next);
+            const double dx = r * c - x, dy = r * s - y;
+            const double f = dx * dx + dy * dy - 1;
+            const double df = 2 * (dx * (c / (2 * PI) - r * s) + dy * (s / (2 * PI) + r * c));
+            const double step = f / df;
+            next -= step;
+            if (std::abs(step) < 1e-12) break;
+        }
+        theta = next;
+        x = theta / (2 * PI) * cos(theta);
+        y = theta / (2 * PI) * sin(theta);
+    }
+}
+
+/* A spiral around an octagram (eight-pointed star), with straight and
+   diagonal unit steps like Math::PlanePath's OctagramSpiral: starting from
+   the origin, ring k starts at (k,0) and runs k steps along each of the 16
+   sides of the star, whose tips are at (2k,k), (k,2k) and their symmetric
+   points, then steps up to the next ring. Ring k lies between the squares
+   of half sides k and 2k, so rings entirely outside the box are skipped. */
+static void
+octagram_spiral(CurveRuns &runs)
+{
+    static const int sides[16][2] = {
+        {1,1}, {-1,0}, {0,1}, {-1,-1}, {-1,1}, {0,-1}, {-1,0}, {1,-1},
+        {-1,-1}, {1,0}, {0,-1}, {1,1}, {1,-1}, {0,1}, {1,0}, {-1,1},
+    };
+    
+    // Chebyshev distances between the origin and the box
+    const double near_x = std::max(0.0, std::max(runs.min_x, -runs.max_x));
+    const double near_y = std::max(0.0, std::max(runs.min_y, -runs.max_y));
+    const double near = std::max(near_x, near_y);
+    const double far = std::max(std::max(-runs.min_x, runs.max_x), std::max(-runs.min_y, runs.max_y));
+    
+    runs.add(0, 0);
+    for (long k = 1; k <= far; ++k) {
+        if (2 * k < near) {
+            runs.cut();
+            continue;
+        }
+        long x = k, y = 0;
+        for (int side = 0; side < 16; ++side) {
+            for (long i = 0; i < k; ++i) {
+                // the last step leads to the next ring
+                if (side == 15 && i == k - 1) break;
+                runs.add(x, y);
+                x += sides[side][0];
+                y += sides[side][1];
+            }
+        }
+        runs.add(x, y);
+    }
+}
+
+/* Infill following a space filling curve, one unit being distance, in the
+   frame of the expolygon. Only the points close to the bounding box of the
+   expolygon are generated, as runs which are then clipped by the
+   expolygon. */
+void
+plane_path(const ExPolygon &expolygon, double distance, PlanePath curve, Polylines &retval)
+{
+    // diagonal steps of the octagram spiral move by one unit along both axes
+    CurveRuns runs(expolygon.bounding_box(), distance, 1);
+    if (curve == ppHilbertCurve) {
+        hilbert_curve(runs);
+    } else if (curve == ppArchimedeanChords) {
+        archimedean_chords(runs);
+    } else {
+        octagram_spiral(runs);
+    }
+    runs.finish();
+    if (runs.runs.empty()) return;
+    
+    Polylines clipped;
+    intersection(runs.runs, (Polygons)expolygon, clipped);
+    retval.insert(retval.end(), clipped.begin(), clipped.end());
+}
+
+}
+
+}
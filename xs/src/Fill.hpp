@@ -0,0 +1,39 @@
+#ifndef slic3r_Fill_hpp_
+#define slic3r_Fill_hpp_
+
+#include <myinit.h>
+#include "ExPolygon.hpp"
+#include "Polyline.hpp"
+
+// filled surfaces remembered by each thread until it moves on to another layer
+#define FILL_CACHE_CAPACITY 16
+
+// same as Slic3r::INFILL_OVERLAP_OVER_SPACING and Slic3r::LOOP_CLIPPING_LENGTH_OVER_SPACING
+#define INFILL_OVERLAP_OVER_SPACING 0.45
+#define LOOP_CLIPPING_LENGTH_OVER_SPACING 0.15
+
+// windows of the honeycomb pattern shared by all threads
+#define HONEYCOMB_CACHE_CAPACITY 16
+
+namespace Slic3r {
+
+namespace Fill {
+
+enum PlanePath { ppHilbertCurve, ppArchimedeanChords, ppOctagramSpiral };
+
+double rectilinear(const ExPolygon &expolygon, double min_spacing, double density,
+    bool is_line_pattern, bool dont_adjust, bool dont_connect, Polylines &retval,
+    bool cached = true);
+double concentric(const ExPolygon &expolygon, double min_spacing, double density,
+    bool dont_adjust, bool incremental, Polylines &retval, unsigned int threads_count = 0);
+void honeycomb(const ExPolygon &expolygon, double min_spacing, double density, double angle,
+    bool complete, Polylines &retval);
+void plane_path(const ExPolygon &expolygon, double distance, PlanePath curve, Polylines &retval);
+void cache_clear();
+void cache_stats(size_t &hits, size_t &misses, size_t &pattern_hits, size_t &pattern_misses);
+
+}
+
+}
+
+#endif
@@ -1,7 +1,9 @@
 #include "Geometry.hpp"
+#include "ExPolygonCollection.hpp"
+#include "ExtrusionEntityCollection.hpp"
+#include "Parallel.hpp"
 #include "clipper.hpp"
 #include <algorithm>
-#include <map>
 #include <vector>
 
 namespace Slic3r { namespace Geometry {
@@ -42,32 +44,43 @@ convex_hull(Points &points, Polygon* hull)
 }
 
 /* accepts an arrayref of points and returns a list of indices
-   according to a nearest-neighbor walk */
+   according to a nearest-neighbor walk; travel orderings pass refine
+   to have the walk shortened by refine_chained_path() */
 void
-chained_path(Points &points, std::vector<Points::size_type> &retval, Point start_near)
+chained_path(Points &points, std::vector<Points::size_type> &retval, Point start_near, bool refine)
 {
-    PointPtrs my_points;
-    std::map<Point*,Points::size_type> indices;
-    my_points.reserve(points.size());
-    for (Points::iterator it = points.begin(); it != points.end(); ++it) {
-        my_points.push_back(&*it);
-        indices[&*it] = it - points.begin();
+    NearestPointIndex index(points);
+    std::vector<size_t> path;
+    path.reserve(points.size());
+    Point last_point = start_near;
+    while (index.size() > 0) {
+        Points::size_type idx = index.nearest(last_point);
+        last_point = points[idx];
+        path.push_back(2*idx);
+        index.remove(idx);
     }
     
-    retval.reserve(points.size());
-    while (!my_points.empty()) {
-        Points::size_type idx = start_near.nearest_point_index(my_points);
-        start_near = *my_points[idx];
-        retval.push_back(indices[ my_points[idx] ]);
-        my_points.erase(my_points.begin() + idx);
+    if (refine) {
+        // points are items whose first and last point coincide
+        Points endpoints;
+        endpoints.reserve(2 * points.size());
+        for (Points::const_iterator it = points.begin(); it != points.end(); ++it) {
+            endpoints.push_back(*it);
+            endpoints.push_back(*it);
+        }
+        refine_chained_path(start_near, endpoints, path, false);
     }
+    
+    retval.reserve(retval.size() + path.size());
+    for (std::vector<size_t>::const_iterator it = path.begin(); it != path.end(); ++it)
+        retval.push_back(*it / 2);
 }
 
 void
-chained_path(Points &points, std::vector<Points::size_type> &retval)
+chained_path(Points &points, std::vector<Points::size_type> &retval, bool refine)
 {
     if (points.empty()) return;  // can't call front() on empty vector
-    chained_path(points, retval, points.front());
+    chained_path(points, retval, points.front(), refine);
 }
 
 /* retval and items must be different containers */
@@ -82,4 +95,911 @@ chained_path_items(Points &points, T &items, T &retval)
 }
 template void chained_path_items(Points &points, ClipperLib::PolyNodes &items, ClipperLib::PolyNodes &retval);
 
-} }
+/* removes the items whose absolute area is below min_area, keeping the order
+   of the others */
+template<class T>
+void
+filter_by_min_area(T &items, double min_area)
+{
+    typename T::iterator last = items.begin();
+    for (typename T::iterator it = items.begin(); it != items.end(); ++it) {
+        if (fabs(it->area()) < min_area) continue;
+        if (last != it) *last = *it;
+        ++last;
+    }
+    items.erase(last, items.end());
+}
+template void filter_by_min_area<Polygons>(Polygons &items, double min_area);
+template void filter_by_min_area<ExPolygons>(ExPolygons &items, double min_area);
+
+/* simplifies a set of independent point sequences, concurrently on up to
+   threads_count threads (0 means one per core) when the whole set is large
+   enough to pay for the threads */
+class DouglasPeuckerJob : public ParallelJob
+{
+    public:
+    std::vector<Points*> rings;
+    double tolerance;
+    unsigned int threads_count;
+    size_t points_count;
+    DouglasPeuckerJob(double _tolerance, unsigned int _threads_count)
+        : tolerance(_tolerance), threads_count(_threads_count), points_count(0) {};
+    void add(Points &points)
+    {
+        this->rings.push_back(&points);
+        this->points_count += points.size();
+    };
+    void run(size_t idx)
+    {
+        Points simplified;
+        MultiPoint::_douglas_peucker(*this->rings[idx], this->tolerance, simplified);
+        this->rings[idx]->swap(simplified);
+    };
+    void run_all()
+    {
+        if (this->points_count < DOUGLAS_PEUCKER_PARALLEL_THRESHOLD) {
+            for (size_t i = 0; i < this->rings.size(); ++i) this->run(i);
+        } else {
+            parallelize(*this, this->rings.size(), this->threads_count);
+        }
+    };
+};
+
+/* simplifies in place the points of each polygon or polyline (of each contour
+   and hole for expolygons); unlike Polygon::simplify() and ExPolygon::simplify()
+   no self-intersection cleanup is performed */
+template <class T>
+void
+douglas_peucker(T &items, double tolerance, unsigned int threads_count)
+{
+    DouglasPeuckerJob job(tolerance, threads_count);
+    for (typename T::iterator it = items.begin(); it != items.end(); ++it)
+        job.add(it->points);
+    job.run_all();
+}
+template void douglas_peucker<Polygons>(Polygons &items, double tolerance, unsigned int threads_count);
+template void douglas_peucker<Polylines>(Polylines &items, double tolerance, unsigned int threads_count);
+
+void
+douglas_peucker(ExPolygons &expolygons, double tolerance, unsigned int threads_count)
+{
+    DouglasPeuckerJob job(tolerance, threads_count);
+    for (ExPolygons::iterator it = expolygons.begin(); it != expolygons.end(); ++it) {
+        job.add(it->contour.points);
+        for (Polygons::iterator h = it->holes.begin(); h != it->holes.end(); ++h)
+            job.add(h->points);
+    }
+    job.run_all();
+}
+
+/* Crossing number test (after Wm. Randolph Franklin), regardless of the
+   polygon orientation. The edge crossing is decided on exact products
+   instead of dividing, so points lying on an edge always get the same answer. */
+bool
+point_in_polygon(const Point &point, const Points &polygon)
+{
+    bool inside = false;
+    if (polygon.empty()) return inside;
+    for (Points::const_iterator i = polygon.begin(), j = polygon.end() - 1; i != polygon.end(); j = i++) {
+        if ((i->y <= point.y && point.y < j->y) || (j->y <= point.y && point.y < i->y)) {
+            // the ray from point to +infinity crosses the edge if
+            // point.x < i->x + (j->x - i->x) * (point.y - i->y) / (j->y - i->y)
+            const coord2_t lhs = (coord2_t)(point.x - i->x) * (j->y - i->y);
+            const coord2_t rhs = (coord2_t)(j->x - i->x) * (point.y - i->y);
+            if (j->y > i->y ? lhs < rhs : lhs > rhs) inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool
+point_in_segment(const Point &point, const Line &line)
+{
+    // check whether the point is in the segment bounding box
+    if (point.x < std::min(line.a.x, line.b.x) || point.x > std::max(line.a.x, line.b.x)
+        || point.y < std::min(line.a.y, line.b.y) || point.y > std::max(line.a.y, line.b.y))
+        return false;
+    
+    // if line is vertical, check whether point's X is the same as the line
+    const coord_t dx = line.b.x - line.a.x;
+    if (dx == 0) return point.x == line.a.x;
+    
+    // the Y of the line at the X of the point is cross/dx away from the point's Y
+    const coord2_t cross = (coord2_t)(point.y - line.a.y) * dx - (coord2_t)(line.b.y - line.a.y) * (point.x - line.a.x);
+    return fabs((double)cross) < EPSILON * fabs((double)dx);
+}
+
+/* returns the index of the first edge of polygon->lines() containing point, or -1 */
+int
+polygon_segment_having_point(const Polygon &polygon, const Point &point)
+{
+    const size_t n = polygon.points.size();
+    for (size_t i = 0; i < n; ++i) {
+        if (point_in_segment(point, Line(polygon.points[i], polygon.points[(i+1) % n]))) return i;
+    }
+    return -1;
+}
+
+/* Intersection of the lines supporting two segments; point and crossing are
+   only set for liPoint, crossing telling whether the intersection lies on
+   both segments. The sequence of tests and operations follows the Perl
+   implementation it replaces so that both return the same values. */
+LineIntersectionType
+line_intersection(const Linef &line1, const Linef &line2, Pointf* point, bool* crossing)
+{
+    const double x0 = line1.a.x, y0 = line1.a.y, x1 = line1.b.x, y1 = line1.b.y;
+    const double x2 = line2.a.x, y2 = line2.a.y, x3 = line2.b.x, y3 = line2.b.y;
+    
+    const double dy10 = y1 - y0, dx10 = x1 - x0;
+    const double dy32 = y3 - y2, dx32 = x3 - x2;
+    const bool dy10z = fabs(dy10) < EPSILON, dx10z = fabs(dx10) < EPSILON;
+    const bool dy32z = fabs(dy32) < EPSILON, dx32z = fabs(dx32) < EPSILON;
+    const double dyx10 = dx10z ? 0 : dy10 / dx10;  // slopes
+    const double dyx32 = dx32z ? 0 : dy32 / dx32;
+    
+    double x, y;
+    if (dx10z && dx32z) {
+        return liParallelVertical;
+    } else if (dy10z && !dy32z) {  // first line horizontal
+        y = y0;
+        x = x2 + (y - y2) * dx32 / dy32;
+    } else if (!dy10z && dy32z) {  // second line horizontal
+        y = y2;
+        x = x0 + (y - y0) * dx10 / dy10;
+    } else if (dx10z && !dx32z) {  // first line vertical
+        x = x0;
+        y = y2 + dyx32 * (x - x2);
+    } else if (!dx10z && dx32z) {  // second line vertical
+        x = x2;
+        y = y0 + dyx10 * (x - x0);
+    } else if (fabs(dyx10 - dyx32) < EPSILON) {
+        const double ya = y0 - dyx10 * x0;
+        const double yb = y2 - dyx32 * x2;
+        return fabs(ya - yb) < EPSILON ? liParallelCollinear : liParallel;
+    } else {
+        x = (y2 - y0 + dyx10*x0 - dyx32*x2) / (dyx10 - dyx32);
+        y = y0 + dyx10 * (x - x0);
+    }
+    
+    const double h10 = dx10 != 0 ? (x - x0) / dx10 : (dy10 != 0 ? (y - y0) / dy10 : 1);
+    const double h32 = dx32 != 0 ? (x - x2) / dx32 : (dy32 != 0 ? (y - y2) / dy32 : 1);
+    point->x = x;
+    point->y = y;
+    *crossing = h10 >= 0 && h10 <= 1 && h32 >= 0 && h32 <= 1;
+    return liPoint;
+}
+
+double
+distance_between_points(const Pointf &p1, const Pointf &p2)
+{
+    const double dx = p1.x - p2.x, dy = p1.y - p2.y;
+    return sqrt(dx*dx + dy*dy);
+}
+
+/* point at distance from p1 towards p2, truncated like Slic3r::Point->new() */
+Point
+point_along_segment(const Pointf &p1, const Pointf &p2, double distance)
+{
+    Pointf p = p1;
+    const double length = distance_between_points(p1, p2);
+    if (p1.x != p2.x) p.x = p1.x + (p2.x - p1.x) * distance / length;
+    if (p1.y != p2.y) p.y = p1.y + (p2.y - p1.y) * distance / length;
+    return Point(p.x, p.y);
+}
+
+/* unlike Point::rotate() this doesn't round the results */
+void
+rotate_points(double angle, const Pointf &center, Pointfs &points)
+{
+    const double c = cos(angle), s = sin(angle);
+    for (Pointfs::iterator it = points.begin(); it != points.end(); ++it) {
+        const double dx = it->x - center.x, dy = it->y - center.y;
+        it->x = center.x + c * dx - s * dy;
+        it->y = center.y + c * dy + s * dx;
+    }
+}
+
+void
+move_points(const Pointf &shift, const Pointfs &points, Points &retval)
+{
+    retval.reserve(retval.size() + points.size());
+    for (Pointfs::const_iterator it = points.begin(); it != points.end(); ++it)
+        retval.push_back(Point(shift.x + it->x, shift.y + it->y));
+}
+
+double
+deg2rad(double angle)
+{
+    return PI * angle / 180;
+}
+
+double
+rad2deg(double angle)
+{
+    return angle / PI * 180;
+}
+
+/* The refinement budget is a number of evaluated moves per ordered item
+   rather than a time limit, so that the resulting order only depends on
+   the input and not on which orderings were refined before it. */
+static size_t travel_refinement_budget = 0;
+static double travel_refinement_total  = 0;
+static Mutex travel_refinement_mutex;
+
+/* this is meant to be called before spawning threads */
+void
+travel_refinement_enable(size_t budget)
+{
+    travel_refinement_budget = budget;
+    MutexLock lock(travel_refinement_mutex);
+    travel_refinement_total = 0;
+}
+
+double
+travel_refinement_saved()
+{
+    MutexLock lock(travel_refinement_mutex);
+    return travel_refinement_total;
+}
+
+static inline double
+travel_distance(const Point &a, const Point &b)
+{
+    const double dx = (double)a.x - b.x, dy = (double)a.y - b.y;
+    return sqrt(dx*dx + dy*dy);
+}
+
+/* First-improvement local search on an open path. Each element of path is the
+   index in endpoints of the point the item is entered from; xoring it with 1
+   gives the point the item is left from, i.e. reverses the item. */
+class TravelRefinement
+{
+    public:
+    double saved;
+    TravelRefinement(const Point &_start, const Points &_endpoints, std::vector<size_t> &_path,
+        bool _no_reverse, size_t &_budget)
+        : saved(0), start(_start), endpoints(_endpoints), path(_path), no_reverse(_no_reverse),
+          budget(_budget) {};
+    void run()
+    {
+        bool improved = true;
+        while (improved && this->budget > 0) {
+            improved = false;
+            if (!this->no_reverse && this->two_opt()) improved = true;
+            for (size_t length = 1; length <= TRAVEL_REFINEMENT_MAX_RUN; ++length)
+                if (this->or_opt(length)) improved = true;
+        }
+    };
+
+    private:
+    const Point &start;
+    const Points &endpoints;
+    std::vector<size_t> &path;
+    bool no_reverse;
+    size_t &budget;
+
+    const Point& head(size_t pos) const { return this->endpoints[ this->path[pos] ]; };
+    const Point& tail(size_t pos) const { return this->endpoints[ this->path[pos] ^ 1 ]; };
+    // where the item at pos is entered from
+    const Point& before(size_t pos) const { return pos == 0 ? this->start : this->tail(pos - 1); };
+    bool spend()
+    {
+        if (this->budget == 0) return false;
+        --this->budget;
+        return true;
+    };
+
+    /* reverses the order of path[lo, hi) along with the direction of each
+       item; closed items keep their direction since it doesn't matter */
+    void reverse(size_t lo, size_t hi)
+    {
+        std::reverse(this->path.begin() + lo, this->path.begin() + hi);
+        for (size_t pos = lo; pos < hi; ++pos) {
+            if (!this->head(pos).coincides_with(this->tail(pos))) this->path[pos] ^= 1;
+        }
+    };
+
+    /* 2-opt: reverse the run of items [i, j] */
+    bool two_opt()
+    {
+        bool improved = false;
+        const size_t n = this->path.size();
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i; j < n; ++j) {
+                if (!this->spend()) return improved;
+                const Point &prev = this->before(i);
+                double delta = travel_distance(prev, this->tail(j)) - travel_distance(prev, this->head(i));
+                if (j + 1 < n)
+                    delta += travel_distance(this->head(i), this->head(j+1))
+                        - travel_distance(this->tail(j), this->head(j+1));
+                if (delta < -TRAVEL_REFINEMENT_MIN_GAIN) {
+                    this->reverse(i, j + 1);
+                    this->saved -= delta;
+                    improved = true;
+                }
+            }
+        }
+        return improved;
+    };
+
+    /* Or-opt: move the run of items [i, i+length) right before the item now
+       at position t (to the end when t == n), reversed if that's shorter */
+    bool or_opt(size_t length)
+    {
+        bool improved = false;
+        const size_t n = this->path.size();
+        for (size_t i = 0; i + length <= n; ++i) {
+            const size_t j = i + length - 1;
+            const Point &prev = this->before(i);
+
+            // travel saved by taking the run out
+            double removal = travel_distance(prev, this->head(i));
+            if (j + 1 < n)
+                removal += travel_distance(this->tail(j), this->head(j+1))
+                    - travel_distance(prev, this->head(j+1));
+
+            bool moved = false;
+            for (size_t t = 0; t <= n && !moved; ++t) {
+                if (t >= i && t <= j + 1) continue;  // that's where the run already is
+                if (!this->spend()) return improved;
+                const Point &a = this->before(t);
+                for (int reversed = 0; reversed <= (this->no_reverse ? 0 : 1) && !moved; ++reversed) {
+                    const Point &first = reversed ? this->tail(j) : this->head(i);
+                    const Point &last  = reversed ? this->head(i) : this->tail(j);
+                    double delta = travel_distance(a, first) - removal;
+                    if (t < n)
+                        delta += travel_distance(last, this->head(t)) - travel_distance(a, this->head(t));
+                    if (delta < -TRAVEL_REFINEMENT_MIN_GAIN) {
+                        size_t lo;
+                        if (t < i) {
+                            std::rotate(this->path.begin() + t, this->path.begin() + i, this->path.begin() + j + 1);
+                            lo = t;
+                        } else {
+                            std::rotate(this->path.begin() + i, this->path.begin() + j + 1, this->path.begin() + t);
+                            lo = t - length;
+                        }
+                        if (reversed) this->reverse(lo, lo + length);
+                        this->saved -= delta;
+                        moved = improved = true;
+                    }
+                }
+            }
+        }
+        return improved;
+    };
+};
+
+/* shortens the travel moves of a nearest-neighbor walk with 2-opt and Or-opt
+   moves until no move helps or the budget of this ordering is spent; endpoints
+   holds the first and last point of each item i at 2*i and 2*i+1, and path the
+   endpoint each item is entered from, in travel order. Returns the travel saved. */
+double
+refine_chained_path(const Point &start_near, const Points &endpoints, std::vector<size_t> &path, bool no_reverse)
+{
+    if (path.size() < 2 || travel_refinement_budget == 0) return 0;
+    size_t budget = travel_refinement_budget * path.size();
+
+    TravelRefinement refinement(start_near, endpoints, path, no_reverse, budget);
+    refinement.run();
+    if (refinement.saved > 0) {
+        MutexLock lock(travel_refinement_mutex);
+        travel_refinement_total += refinement.saved;
+    }
+    return refinement.saved;
+}
+
+}
+
+void
+ConvexHull::append(const Points &points)
+{
+    Points candidates = points;
+    this->merge(candidates);
+}
+
+void
+ConvexHull::append(const Polylines &polylines)
+{
+    Points candidates;
+    for (Polylines::const_iterator it = polylines.begin(); it != polylines.end(); ++it)
+        candidates.insert(candidates.end(), it->points.begin(), it->points.end());
+    this->merge(candidates);
+}
+
+void
+ConvexHull::append(const ExPolygons &expolygons)
+{
+    Points candidates;
+    for (ExPolygons::const_iterator it = expolygons.begin(); it != expolygons.end(); ++it)
+        candidates.insert(candidates.end(), it->contour.points.begin(), it->contour.points.end());
+    this->merge(candidates);
+}
+
+void
+ConvexHull::append(const ExPolygonCollection &collection)
+{
+    this->append(collection.expolygons);
+}
+
+void
+ConvexHull::append(const ExtrusionEntityCollection &collection)
+{
+    Points candidates;
+    for (ExtrusionEntitiesPtr::const_iterator it = collection.entities.begin(); it != collection.entities.end(); ++it) {
+        if (ExtrusionPath* path = dynamic_cast<ExtrusionPath*>(*it)) {
+            candidates.insert(candidates.end(), path->polyline.points.begin(), path->polyline.points.end());
+        } else if (ExtrusionLoop* loop = dynamic_cast<ExtrusionLoop*>(*it)) {
+            candidates.insert(candidates.end(), loop->polygon.points.begin(), loop->polygon.points.end());
+        } else {
+            this->append(*(ExtrusionEntityCollection*)*it);
+        }
+    }
+    this->merge(candidates);
+}
+
+/* adds a copy of another hull translated by shift: appending an object's hull
+   once per copy avoids feeding every copy's points */
+void
+ConvexHull::append(const ConvexHull &other, const Point &shift)
+{
+    Points candidates = other.points;
+    for (Points::iterator it = candidates.begin(); it != candidates.end(); ++it)
+        it->translate(shift.x, shift.y);
+    this->merge(candidates);
+}
+
+Polygon
+ConvexHull::polygon() const
+{
+    Polygon hull;
+    hull.points = this->points;
+    return hull;
+}
+
+void
+ConvexHull::merge(Points &candidates)
+{
+    if (candidates.empty()) return;
+    candidates.insert(candidates.end(), this->points.begin(), this->points.end());
+    if (candidates.size() < 3) {
+        this->points.swap(candidates);
+        return;
+    }
+    Polygon hull;
+    Geometry::convex_hull(candidates, &hull);
+    this->points.swap(hull.points);
+}
+
+static inline double
+squared_distance(const Point &a, const Point &b)
+{
+    return pow(a.x - b.x, 2) + pow(a.y - b.y, 2);
+}
+
+struct CompareCoordinate
+{
+    const Points* points;
+    bool x;
+    CompareCoordinate(const Points* _points, bool _x) : points(_points), x(_x) {};
+    bool operator()(size_t a, size_t b) const
+    {
+        return this->x ? (*this->points)[a].x < (*this->points)[b].x : (*this->points)[a].y < (*this->points)[b].y;
+    };
+};
+
+NearestPointIndex::NearestPointIndex(const Points &points)
+    : points(points), order(points.size()), position(points.size()), nodes(points.size()),
+      removed(points.size(), false), remaining(points.size())
+{
+    for (size_t i = 0; i < points.size(); ++i) this->order[i] = i;
+    this->build(0, points.size());
+    for (size_t i = 0; i < points.size(); ++i) this->position[ this->order[i] ] = i;
+}
+
+/* the subtree covering order[lo, hi) is rooted at its median position */
+void
+NearestPointIndex::build(size_t lo, size_t hi)
+{
+    if (lo >= hi) return;
+    const size_t mid = (lo + hi) / 2;
+    Node &node = this->nodes[mid];
+    const Point &first = this->points[ this->order[lo] ];
+    node.min_x = node.max_x = first.x;
+    node.min_y = node.max_y = first.y;
+    for (size_t i = lo + 1; i < hi; ++i) {
+        const Point &p = this->points[ this->order[i] ];
+        node.min_x = std::min(node.min_x, p.x);
+        node.max_x = std::max(node.max_x, p.x);
+        node.min_y = std::min(node.min_y, p.y);
+        node.max_y = std::max(node.max_y, p.y);
+    }
+    node.alive   = hi - lo;
+    node.split_x = (node.max_x - node.min_x) >= (node.max_y - node.min_y);
+    std::nth_element(this->order.begin() + lo, this->order.begin() + mid, this->order.begin() + hi,
+        CompareCoordinate(&this->points, node.split_x));
+    this->build(lo, mid);
+    this->build(mid + 1, hi);
+}
+
+long
+NearestPointIndex::nearest(const Point &point) const
+{
+    long best = -1;
+    double best_distance = 0;
+    this->search(point, 0, this->points.size(), best, best_distance);
+    return best;
+}
+
+void
+NearestPointIndex::search(const Point &point, size_t lo, size_t hi, long &best, double &best_distance) const
+{
+    if (lo >= hi) return;
+    const size_t mid = (lo + hi) / 2;
+    const Node &node = this->nodes[mid];
+    if (node.alive == 0) return;
+    if (best != -1) {
+        // ties must still be visited, so only prune strictly farther subtrees
+        Point nearest_corner(
+            std::min(std::max(point.x, node.min_x), node.max_x),
+            std::min(std::max(point.y, node.min_y), node.max_y)
+        );
+        if (squared_distance(point, nearest_corner) > best_distance) return;
+    }
+    
+    const size_t idx = this->order[mid];
+    const Point &p = this->points[idx];
+    if (!this->removed[idx]) {
+        double d = squared_distance(point, p);
+        if (best == -1 || d < best_distance
+            || (d == best_distance && (d < EPSILON ? (long)idx < best : (long)idx > best))) {
+            best = idx;
+            best_distance = d;
+        }
+    }
+    
+    if (node.split_x ? point.x < p.x : point.y < p.y) {
+        this->search(point, lo, mid, best, best_distance);
+        this->search(point, mid + 1, hi, best, best_distance);
+    } else {
+        this->search(point, mid + 1, hi, best, best_distance);
+        this->search(point, lo, mid, best, best_distance);
+    }
+}
+
+void
+NearestPointIndex::remove(size_t idx)
+{
+    if (this->removed[idx]) return;
+    this->removed[idx] = true;
+    --this->remaining;
+    const size_t pos = this->position[idx];
+    size_t lo = 0, hi = this->points.size();
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        --this->nodes[mid].alive;
+        if (pos == mid) break;
+        if (pos < mid) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+}
+
+DelaunayTriangulation::DelaunayTriangulation(const Points &_points)
+    : points(_points), last(0), exact(false)
+{
+    const size_t n = this->points.size();
+    if (n < 3) return;
+    
+    // in_circumcircle() sums products of four coordinate differences,
+    // which fit a coord2_t as long as these differences stay below 2^30
+    BoundingBox bb(this->points);
+    this->exact = (double)bb.max.x - (double)bb.min.x < 1073741824.0
+        && (double)bb.max.y - (double)bb.min.y < 1073741824.0;
+    
+    // start from the first three points not being collinear
+    size_t a = 0, b = 1, c;
+    while (b < n && this->points[b].coincides_with(this->points[a])) ++b;
+    if (b >= n) return;
+    for (c = b + 1; c < n && this->orientation(a, b, c) == 0; ++c) ;
+    if (c >= n) return;
+    if (this->orientation(a, b, c) < 0) std::swap(b, c);
+    
+    // the triangle and the three ghosts lying beyond its edges
+    this->triangles.resize(4);
+    Triangle* t = &this->triangles.front();
+    t[0].v[0] = a;     t[0].v[1] = b;     t[0].v[2] = c;
+    t[0].n[0] = 1;     t[0].n[1] = 2;     t[0].n[2] = 3;
+    t[1].v[0] = c;     t[1].v[1] = b;     t[1].v[2] = GHOST;
+    t[1].n[0] = 3;     t[1].n[1] = 2;     t[1].n[2] = 0;
+    t[2].v[0] = a;     t[2].v[1] = c;     t[2].v[2] = GHOST;
+    t[2].n[0] = 1;     t[2].n[1] = 3;     t[2].n[2] = 0;
+    t[3].v[0] = b;     t[3].v[1] = a;     t[3].v[2] = GHOST;
+    t[3].n[0] = 2;     t[3].n[1] = 1;     t[3].n[2] = 0;
+    
+    this->triangles.reserve(2 * n + 2);
+    for (size_t p = 0; p < n; ++p) {
+        if (p != a && p != b && p != c) this->insert(p);
+    }
+}
+
+int
+DelaunayTriangulation::orientation(size_t a, size_t b, size_t c) const
+{
+    const Point &pa = this->points[a], &pb = this->points[b], &pc = this->points[c];
+    const coord2_t cross = (coord2_t)(pb.x - pa.x) * (pc.y - pa.y) - (coord2_t)(pb.y - pa.y) * (pc.x - pa.x);
+    return (cross > 0) - (cross < 0);
+}
+
+/* whether p, collinear with a and b, lies strictly between them */
+bool
+DelaunayTriangulation::between(size_t a, size_t b, size_t p) const
+{
+    const Point &pa = this->points[a], &pb = this->points[b], &pp = this->points[p];
+    return (coord2_t)(pp.x - pa.x) * (pb.x - pa.x) + (coord2_t)(pp.y - pa.y) * (pb.y - pa.y) > 0
+        && (coord2_t)(pp.x - pb.x) * (pa.x - pb.x) + (coord2_t)(pp.y - pb.y) * (pa.y - pb.y) > 0;
+}
+
+/* The circumcircle of a ghost triangle is the open half-plane beyond its
+   hull edge, plus the open edge itself. */
+bool
+DelaunayTriangulation::in_circumcircle(const Triangle &t, size_t p) const
+{
+    for (int g = 0; g < 3; ++g) {
+        if (t.v[g] != GHOST) continue;
+        const size_t a = t.v[(g+1) % 3], b = t.v[(g+2) % 3];
+        const int o = this->orientation(a, b, p);
+        return o > 0 || (o == 0 && this->between(a, b, p));
+    }
+    
+    const Point &d = this->points[p];
+    const Point &a = this->points[t.v[0]], &b = this->points[t.v[1]], &c = this->points[t.v[2]];
+    if (this->exact) {
+        const coord2_t adx = a.x - d.x, ady = a.y - d.y;
+        const coord2_t bdx = b.x - d.x, bdy = b.y - d.y;
+        const coord2_t cdx = c.x - d.x, cdy = c.y - d.y;
+        return (adx*adx + ady*ady) * (bdx*cdy - cdx*bdy)
+             + (bdx*bdx + bdy*bdy) * (cdx*ady - adx*cdy)
+             + (cdx*cdx + cdy*cdy) * (adx*bdy - bdx*ady) > 0;
+    }
+    const long double adx = a.x - d.x, ady = a.y - d.y;
+    const long double bdx = b.x - d.x, bdy = b.y - d.y;
+    const long double cdx = c.x - d.x, cdy = c.y - d.y;
+    return (adx*adx + ady*ady) * (bdx*cdy - cdx*bdy)
+         + (bdx*bdx + bdy*bdy) * (cdx*ady - adx*cdy)
+         + (cdx*cdx + cdy*cdy) * (adx*bdy - bdx*ady) > 0;
+}
+
+/* rounded to the nearest point, and clamped to the coordinate range since
+   nearly flat triangles have their circumcenter almost at infinity */
+Point
+DelaunayTriangulation::circumcenter(const Triangle &t) const
+{
+    const Point &a = this->points[t.v[0]], &b = this->points[t.v[1]], &c = this->points[t.v[2]];
+    const coord2_t bx = b.x - a.x, by = b.y - a.y;
+    const coord2_t cx = c.x - a.x, cy = c.y - a.y;
+    const coord2_t bl = bx*bx + by*by, cl = cx*cx + cy*cy;
+    const long double d = 2 * (long double)(bx*cy - by*cx);
+    const long double x = a.x + (long double)(cy*bl - by*cl) / d;
+    const long double y = a.y + (long double)(bx*cl - cx*bl) / d;
+    const long double max = COORD_MAX;
+    return Point(
+        (coord_t)roundl(std::min(std::max(x, -max), max)),
+        (coord_t)roundl(std::min(std::max(y, -max), max))
+    );
+}
+
+/* Visibility walk towards p, which terminates since the triangulation is
+   kept Delaunay. Sets t to the triangle containing p and edge to the index
+   of the vertex opposite the edge p lies on, or -1; returns false if p is
+   already a vertex. */
+bool
+DelaunayTriangulation::locate(size_t p, size_t &t, int &edge)
+{
+    t = this->last;
+    for (;;) {
+        const Triangle &tr = this->triangles[t];
+        int g = -1;
+        for (int i = 0; i < 3; ++i) {
+            if (tr.v[i] == GHOST) g = i;
+        }
+        
+        if (g == -1) {
+            int zeros = 0;
+            edge = -1;
+            bool moved = false;
+            for (int i = 0; i < 3 && !moved; ++i) {
+                const int o = this->orientation(tr.v[(i+1) % 3], tr.v[(i+2) % 3], p);
+                if (o < 0) {
+                    t = tr.n[i];
+                    moved = true;
+                } else if (o == 0) {
+                    edge = i;
+                    ++zeros;
+                }
+            }
+            if (moved) continue;
+            return zeros < 2;
+        }
+        
+        const size_t a = tr.v[(g+1) % 3], b = tr.v[(g+2) % 3];
+        const int o = this->orientation(a, b, p);
+        if (o > 0) {
+            edge = -1;
+            return true;
+        } else if (o < 0) {
+            t = tr.n[g];
+        } else if (this->between(a, b, p)) {
+            edge = g;
+            return true;
+        } else if (this->points[p].coincides_with(this->points[a]) || this->points[p].coincides_with(this->points[b])) {
+            return false;
+        } else {
+            // on the line of this hull edge: move along the hull towards p
+            const Point &pa = this->points[a], &pb = this->points[b], &pp = this->points[p];
+            const bool beyond_b = (coord2_t)(pp.x - pb.x) * (pb.x - pa.x) + (coord2_t)(pp.y - pb.y) * (pb.y - pa.y) > 0;
+            t = tr.n[beyond_b ? (g+1) % 3 : (g+2) % 3];
+        }
+    }
+}
+
+void
+DelaunayTriangulation::insert(size_t p)
+{
+    size_t t;
+    int edge;
+    if (!this->locate(p, t, edge)) return;
+    
+    std::vector<size_t> stack;
+    if (edge == -1) {
+        this->split_triangle(t, p, stack);
+    } else {
+        this->split_edge(t, edge, p, stack);
+    }
+    this->legalize(p, stack);
+    this->last = t;
+}
+
+void
+DelaunayTriangulation::replace_neighbor(size_t t, size_t from, size_t to)
+{
+    Triangle &tr = this->triangles[t];
+    for (int i = 0; i < 3; ++i) {
+        if (tr.n[i] == from) tr.n[i] = to;
+    }
+}
+
+/* replaces t with (p, v1, v2), (p, v2, v0) and (p, v0, v1) */
+void
+DelaunayTriangulation::split_triangle(size_t t, size_t p, std::vector<size_t> &stack)
+{
+    const Triangle old = this->triangles[t];
+    const size_t t1 = this->triangles.size(), t2 = t1 + 1;
+    this->triangles.resize(t1 + 2);
+    
+    Triangle &a = this->triangles[t], &b = this->triangles[t1], &c = this->triangles[t2];
+    a.v[0] = p; a.v[1] = old.v[1]; a.v[2] = old.v[2];
+    a.n[0] = old.n[0]; a.n[1] = t1; a.n[2] = t2;
+    b.v[0] = p; b.v[1] = old.v[2]; b.v[2] = old.v[0];
+    b.n[0] = old.n[1]; b.n[1] = t2; b.n[2] = t;
+    c.v[0] = p; c.v[1] = old.v[0]; c.v[2] = old.v[1];
+    c.n[0] = old.n[2]; c.n[1] = t; c.n[2] = t1;
+    this->replace_neighbor(old.n[1], t, t1);
+    this->replace_neighbor(old.n[2], t, t2);
+    
+    stack.push_back(t);
+    stack.push_back(t1);
+    stack.push_back(t2);
+}
+
+/* splits the edge opposite to the i-th vertex of t, and the neighbor triangle
+   sharing it, at p */
+void
+DelaunayTriangulation::split_edge(size_t t, int i, size_t p, std::vector<size_t> &stack)
+{
+    const size_t u = this->triangles[t].n[i];
+    int j = 0;
+    while (this->triangles[u].n[j] != t) ++j;
+    const Triangle ot = this->triangles[t], ou = this->triangles[u];
+    const size_t x = ot.v[i], e0 = ot.v[(i+1) % 3], e1 = ot.v[(i+2) % 3], y = ou.v[j];
+    const size_t t2 = this->triangles.size(), u2 = t2 + 1;
+    this->triangles.resize(t2 + 2);
+    
+    // t becomes (x, e0, p), t2 (x, p, e1), u (y, e1, p) and u2 (y, p, e0)
+    Triangle &ta = this->triangles[t], &tb = this->triangles[t2];
+    Triangle &ua = this->triangles[u], &ub = this->triangles[u2];
+    ta.v[0] = x; ta.v[1] = e0; ta.v[2] = p;
+    ta.n[0] = u2; ta.n[1] = t2; ta.n[2] = ot.n[(i+2) % 3];
+    tb.v[0] = x; tb.v[1] = p; tb.v[2] = e1;
+    tb.n[0] = u; tb.n[1] = ot.n[(i+1) % 3]; tb.n[2] = t;
+    ua.v[0] = y; ua.v[1] = e1; ua.v[2] = p;
+    ua.n[0] = t2; ua.n[1] = u2; ua.n[2] = ou.n[(j+2) % 3];
+    ub.v[0] = y; ub.v[1] = p; ub.v[2] = e0;
+    ub.n[0] = t; ub.n[1] = ou.n[(j+1) % 3]; ub.n[2] = u;
+    this->replace_neighbor(ot.n[(i+1) % 3], t, t2);
+    this->replace_neighbor(ou.n[(j+1) % 3], u, u2);
+    
+    stack.push_back(t);
+    stack.push_back(t2);
+    stack.push_back(u);
+    stack.push_back(u2);
+}
+
+/* Lawson flips of the edges facing p in the triangles on the stack, until
+   every edge is locally Delaunay again. */
+void
+DelaunayTriangulation::legalize(size_t p, std::vector<size_t> &stack)
+{
+    while (!stack.empty()) {
+        const size_t t = stack.back();
+        stack.pop_back();
+        int i = 0;
+        while (i < 3 && this->triangles[t].v[i] != p) ++i;
+        if (i == 3) continue;  // already flipped away
+        
+        const size_t u = this->triangles[t].n[i];
+        if (!this->in_circumcircle(this->triangles[u], p)) continue;
+        int j = 0;
+        while (this->triangles[u].n[j] != t) ++j;
+        
+        // (p, a, b) and (d, b, a) become (p, a, d) and (p, d, b)
+        const Triangle ot = this->triangles[t], ou = this->triangles[u];
+        const size_t a = ot.v[(i+1) % 3], b = ot.v[(i+2) % 3], d = ou.v[j];
+        Triangle &nt = this->triangles[t], &nu = this->triangles[u];
+        nt.v[0] = p; nt.v[1] = a; nt.v[2] = d;
+        nt.n[0] = ou.n[(j+1) % 3]; nt.n[1] = u; nt.n[2] = ot.n[(i+2) % 3];
+        nu.v[0] = p; nu.v[1] = d; nu.v[2] = b;
+        nu.n[0] = ou.n[(j+2) % 3]; nu.n[1] = ot.n[(i+1) % 3]; nu.n[2] = t;
+        this->replace_neighbor(ou.n[(j+1) % 3], u, t);
+        this->replace_neighbor(ot.n[(i+1) % 3], t, u);
+        
+        stack.push_back(t);
+        stack.push_back(u);
+    }
+}
+
+static bool
+points_coincide(const Point &a, const Point &b)
+{
+    return a.coincides_with(b);
+}
+
+/* The Voronoi diagram of the points is dual to the triangulation: its
+   vertices are the circumcenters of the triangles (merged when they round
+   to the same point) and each edge shared by two triangles yields an edge
+   between their circumcenters. Edges going to infinity are left out. */
+void
+DelaunayTriangulation::voronoi(Points &vertices, std::vector< std::pair<size_t,size_t> > &edges) const
+{
+    Points centers(this->triangles.size());
+    std::vector<bool> ghost(this->triangles.size(), false);
+    for (size_t t = 0; t < this->triangles.size(); ++t) {
+        const Triangle &tr = this->triangles[t];
+        ghost[t] = tr.v[0] == GHOST || tr.v[1] == GHOST || tr.v[2] == GHOST;
+        if (!ghost[t]) centers[t] = this->circumcenter(tr);
+    }
+    
+    size_t first = vertices.size();
+    for (size_t t = 0; t < this->triangles.size(); ++t) {
+        if (!ghost[t]) vertices.push_back(centers[t]);
+    }
+    std::sort(vertices.begin() + first, vertices.end(), Geometry::sort_points);
+    vertices.erase(std::unique(vertices.begin() + first, vertices.end(), points_coincide), vertices.end());
+    
+    std::vector<size_t> vertex(this->triangles.size());
+    for (size_t t = 0; t < this->triangles.size(); ++t) {
+        if (!ghost[t])
+            vertex[t] = std::lower_bound(vertices.begin() + first, vertices.end(), centers[t], Geometry::sort_points) - vertices.begin();
+    }
+    for (size_t t = 0; t < this->triangles.size(); ++t) {
+        if (ghost[t]) continue;
+        for (int i = 0; i < 3; ++i) {
+            const size_t u = this->triangles[t].n[i];
+            if (u > t && !ghost[u] && vertex[t] != vertex[u])
+                edges.push_back(std::make_pair(vertex[t], vertex[u]));
+        }
+    }
+}
+
+}
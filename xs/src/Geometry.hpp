@@ -2,14 +2,133 @@
 #define slic3r_Geometry_hpp_
 
 #include "Polygon.hpp"
+#include "ExPolygon.hpp"
 
-namespace Slic3r { namespace Geometry {
+// below this number of input points douglas_peucker() runs in the calling thread
+#define DOUGLAS_PEUCKER_PARALLEL_THRESHOLD 50000
+
+// longest run of consecutive items that the travel refinement tries to move
+#define TRAVEL_REFINEMENT_MAX_RUN 3
+// travel refinement moves saving less than this (in scaled units) are ignored
+#define TRAVEL_REFINEMENT_MIN_GAIN 1000
+
+namespace Slic3r {
+
+class ExPolygonCollection;
+class ExtrusionEntityCollection;
+
+namespace Geometry {
+
+enum LineIntersectionType { liPoint, liParallel, liParallelCollinear, liParallelVertical };
 
 void convex_hull(Points &points, Polygon* hull);
-void chained_path(Points &points, std::vector<Points::size_type> &retval, Point start_near);
-void chained_path(Points &points, std::vector<Points::size_type> &retval);
+void chained_path(Points &points, std::vector<Points::size_type> &retval, Point start_near, bool refine = false);
+void chained_path(Points &points, std::vector<Points::size_type> &retval, bool refine = false);
 template<class T> void chained_path_items(Points &points, T &items, T &retval);
+template<class T> void filter_by_min_area(T &items, double min_area);
+template<class T> void douglas_peucker(T &items, double tolerance, unsigned int threads_count = 0);
+void douglas_peucker(ExPolygons &expolygons, double tolerance, unsigned int threads_count = 0);
+void travel_refinement_enable(size_t budget);
+double travel_refinement_saved();
+double refine_chained_path(const Point &start_near, const Points &endpoints, std::vector<size_t> &path, bool no_reverse);
+bool point_in_polygon(const Point &point, const Points &polygon);
+bool point_in_segment(const Point &point, const Line &line);
+int polygon_segment_having_point(const Polygon &polygon, const Point &point);
+LineIntersectionType line_intersection(const Linef &line1, const Linef &line2, Pointf* point, bool* crossing);
+double distance_between_points(const Pointf &p1, const Pointf &p2);
+Point point_along_segment(const Pointf &p1, const Pointf &p2, double distance);
+void rotate_points(double angle, const Pointf &center, Pointfs &points);
+void move_points(const Pointf &shift, const Pointfs &points, Points &retval);
+double deg2rad(double angle);
+double rad2deg(double angle);
+
+}
+
+/* Running convex hull of everything appended so far. Each batch is merged
+   with the current hull right away and only the hull vertices are kept, so
+   memory is bounded by the hull size; holes are skipped since they can't
+   contribute any hull vertex. */
+class ConvexHull
+{
+    public:
+    Points points;  // counter-clockwise hull vertices (raw points while fewer than three)
+    void append(const Points &points);
+    void append(const Polylines &polylines);
+    void append(const ExPolygons &expolygons);
+    void append(const ExPolygonCollection &collection);
+    void append(const ExtrusionEntityCollection &collection);
+    void append(const ConvexHull &other, const Point &shift);
+    Polygon polygon() const;
+    
+    private:
+    void merge(Points &candidates);
+};
+
+/* Static 2D tree over a set of points from which points can be removed.
+   nearest() returns the same index as Point::nearest_point_index() would on
+   the remaining points kept in their original order (the first point at zero
+   distance, otherwise the last one among equally near points), so that
+   nearest-neighbor walks built on it are unchanged but take O(n log n). */
+class NearestPointIndex
+{
+    public:
+    explicit NearestPointIndex(const Points &points);
+    size_t size() const { return this->remaining; };
+    long nearest(const Point &point) const;
+    void remove(size_t idx);
+    
+    private:
+    struct Node
+    {
+        coord_t min_x, max_x, min_y, max_y;  // bounding box of the subtree
+        size_t alive;                     // points of the subtree not yet removed
+        bool split_x;
+    };
+    const Points &points;
+    std::vector<size_t> order;  // point indices, laid out as an implicit tree
+    std::vector<size_t> position;  // position of each point in order
+    std::vector<Node> nodes;    // one per position, for the subtree rooted there
+    std::vector<bool> removed;
+    size_t remaining;
+    void build(size_t lo, size_t hi);
+    void search(const Point &point, size_t lo, size_t hi, long &best, double &best_distance) const;
+};
+
+/* Delaunay triangulation of a set of points, built by incremental insertion
+   and edge flips. The outside of the hull is covered by ghost triangles
+   sharing a vertex at infinity, so that points falling outside the current
+   hull need no special case. Predicates are exact as long as the points span
+   less than 2^30 units in each direction. Duplicate points are ignored and
+   there are no triangles at all if every point is collinear. */
+class DelaunayTriangulation
+{
+    public:
+    explicit DelaunayTriangulation(const Points &points);
+    void voronoi(Points &vertices, std::vector< std::pair<size_t,size_t> > &edges) const;
+    
+    private:
+    static const size_t GHOST = (size_t)-1;
+    struct Triangle
+    {
+        size_t v[3];  // counter-clockwise vertices, GHOST being the vertex at infinity
+        size_t n[3];  // n[i] is the triangle across the edge opposite v[i]
+    };
+    const Points &points;
+    std::vector<Triangle> triangles;
+    size_t last;  // triangle where the next point location starts
+    bool exact;
+    int orientation(size_t a, size_t b, size_t c) const;
+    bool between(size_t a, size_t b, size_t p) const;
+    bool in_circumcircle(const Triangle &t, size_t p) const;
+    Point circumcenter(const Triangle &t) const;
+    bool locate(size_t p, size_t &t, int &edge);
+    void insert(size_t p);
+    void split_triangle(size_t t, size_t p, std::vector<size_t> &stack);
+    void split_edge(size_t t, int i, size_t p, std::vector<size_t> &stack);
+    void legalize(size_t p, std::vector<size_t> &stack);
+    void replace_neighbor(size_t t, size_t from, size_t to);
+};
 
-} }
+}
 
 #endif
@@ -45,21 +45,21 @@ Line::length() const
     return this->a.distance_to(&(this->b));
 }
 
-Point*
+Point
 Line::midpoint() const
 {
-    return new Point ((this->a.x + this->b.x) / 2.0, (this->a.y + this->b.y) / 2.0);
+    return Point((this->a.x + this->b.x) / 2.0, (this->a.y + this->b.y) / 2.0);
 }
 
-Point*
+Point
 Line::point_at(double distance) const
 {
     double len = this->length();
-    Point* p = new Point(this->a);
+    Point p = this->a;
     if (this->a.x != this->b.x)
-        p->x = this->a.x + (this->b.x - this->a.x) * distance / len;
+        p.x = this->a.x + (this->b.x - this->a.x) * distance / len;
     if (this->a.y != this->b.y)
-        p->y = this->a.y + (this->b.y - this->a.y) * distance / len;
+        p.y = this->a.y + (this->b.y - this->a.y) * distance / len;
     return p;
 }
 
@@ -132,6 +132,26 @@ Line::to_SV_pureperl() const {
     av_store(av, 1, this->b.to_SV_pureperl());
     return newRV_noinc((SV*)av);
 }
+
+void
+Linef::from_SV(SV* line_sv)
+{
+    AV* line_av = (AV*)SvRV(line_sv);
+    this->a.from_SV_check(*av_fetch(line_av, 0, 0));
+    this->b.from_SV_check(*av_fetch(line_av, 1, 0));
+}
+
+void
+Linef::from_SV_check(SV* line_sv)
+{
+    if (sv_isobject(line_sv) && (SvTYPE(SvRV(line_sv)) == SVt_PVMG)) {
+        Line* line = (Line*)SvIV((SV*)SvRV( line_sv ));
+        this->a = Pointf(line->a.x, line->a.y);
+        this->b = Pointf(line->b.x, line->b.y);
+    } else {
+        this->from_SV(line_sv);
+    }
+}
 #endif
 
 }
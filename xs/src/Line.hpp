@@ -22,8 +22,8 @@ class Line
     void rotate(double angle, Point* center);
     void reverse();
     double length() const;
-    Point* midpoint() const;
-    Point* point_at(double distance) const;
+    Point midpoint() const;
+    Point point_at(double distance) const;
     bool coincides_with(const Line* line) const;
     double distance_to(const Point* point) const;
     
@@ -39,6 +39,20 @@ class Line
 
 typedef std::vector<Line> Lines;
 
+class Linef
+{
+    public:
+    Pointf a;
+    Pointf b;
+    Linef() {};
+    explicit Linef(Pointf _a, Pointf _b): a(_a), b(_b) {};
+    
+    #ifdef SLIC3RXS
+    void from_SV(SV* line_sv);
+    void from_SV_check(SV* line_sv);
+    #endif
+};
+
 }
 
 #endif
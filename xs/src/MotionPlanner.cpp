@@ -0,0 +1,360 @@
+#include "MotionPlanner.hpp"
+#include "BoundingBox.hpp"
+#include "ClipperUtils.hpp"
+#include "ExPolygonCollection.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace Slic3r {
+
+static bool
+sort_points(const Point &a, const Point &b)
+{
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+static bool
+points_coincide(const Point &a, const Point &b)
+{
+    return a.coincides_with(b);
+}
+
+static void
+append_points(const ExPolygons &expolygons, Points &points)
+{
+    for (ExPolygons::const_iterator ex = expolygons.begin(); ex != expolygons.end(); ++ex) {
+        points.insert(points.end(), ex->contour.points.begin(), ex->contour.points.end());
+        for (Polygons::const_iterator hole = ex->holes.begin(); hole != ex->holes.end(); ++hole)
+            points.insert(points.end(), hole->points.begin(), hole->points.end());
+    }
+}
+
+static void
+append_points(const Polygons &polygons, Points &points)
+{
+    for (Polygons::const_iterator p = polygons.begin(); p != polygons.end(); ++p)
+        points.insert(points.end(), p->points.begin(), p->points.end());
+}
+
+/* setup our configuration space */
+MotionPlanner::MotionPlanner(const ExPolygons &_islands, bool _no_internal)
+    : last_crossings(0), no_internal(_no_internal)
+{
+    // simplify islands
+    for (ExPolygons::const_iterator island = _islands.begin(); island != _islands.end(); ++island)
+        island->simplify(MP_INNER_MARGIN, this->islands);
+    
+    // process individual islands
+    const size_t n = this->islands.size();
+    this->inner.resize(n);
+    this->outer.resize(n);
+    this->contours_ex.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        // offset the island inwards to make the boundaries for internal movements
+        // so that no motion along external perimeters happens
+        if (!this->no_internal)
+            offset_ex(this->islands[i], this->inner[i], -MP_INNER_MARGIN);
+        
+        // offset the island outwards to make the boundaries for external movements
+        offset(Polygons(1, this->islands[i].contour), this->outer[i], MP_OUTER_MARGIN);
+        
+        // if internal motion is enabled, build a set of utility expolygons representing
+        // the outer boundaries (as contours) and the inner boundaries (as holes). whenever
+        // we jump from a hole to a contour or viceversa, we know we're crossing a perimeter
+        if (!this->no_internal) {
+            Polygons inner_contours;
+            for (ExPolygons::const_iterator ex = this->inner[i].begin(); ex != this->inner[i].end(); ++ex)
+                inner_contours.push_back(ex->contour);
+            diff(this->outer[i], inner_contours, this->contours_ex[i], false);
+        }
+    }
+    
+    for (size_t i = 0; i < n; ++i) {
+        append_points(this->inner[i], this->nodes);
+        append_points(this->outer[i], this->nodes);
+        append_points(this->contours_ex[i], this->nodes);
+    }
+    std::sort(this->nodes.begin(), this->nodes.end(), sort_points);
+    this->nodes.erase(std::unique(this->nodes.begin(), this->nodes.end(), points_coincide), this->nodes.end());
+    
+    if (!this->no_internal) {
+        for (size_t i = 0; i < n; ++i) {
+            // lines enclosed in inner expolygons are visible
+            for (ExPolygons::const_iterator ex = this->inner[i].begin(); ex != this->inner[i].end(); ++ex)
+                this->add_expolygon(*ex, false);
+            
+            // lines enclosed in expolygons covering perimeters are visible
+            // (but discouraged)
+            for (ExPolygons::const_iterator ex = this->contours_ex[i].begin(); ex != this->contours_ex[i].end(); ++ex)
+                this->add_expolygon(*ex, true);
+        }
+    }
+    
+    {
+        Polygons outer;
+        for (size_t i = 0; i < n; ++i)
+            outer.insert(outer.end(), this->outer[i].begin(), this->outer[i].end());
+        
+        // lines of outer polygons connect visible points
+        for (Polygons::const_iterator p = outer.begin(); p != outer.end(); ++p) {
+            Lines lines = p->lines();
+            for (Lines::const_iterator line = lines.begin(); line != lines.end(); ++line)
+                this->add_edge(line->a, line->b, line->length(), false);
+        }
+        
+        // lines connecting outer polygons are visible
+        this->add_visible_pairs(outer, 1, false);
+    }
+    
+    // lines connecting inner polygons contours are visible but discouraged
+    if (!this->no_internal) {
+        Polygons inner_contours;
+        for (size_t i = 0; i < n; ++i) {
+            for (ExPolygons::const_iterator ex = this->inner[i].begin(); ex != this->inner[i].end(); ++ex)
+                inner_contours.push_back(ex->contour);
+        }
+        this->add_visible_pairs(inner_contours, MP_CROSSING_FACTOR, true);
+    }
+    
+    this->build_graph();
+}
+
+size_t
+MotionPlanner::node(const Point &point) const
+{
+    return std::lower_bound(this->nodes.begin(), this->nodes.end(), point, sort_points) - this->nodes.begin();
+}
+
+/* edges are undirected; adding one again replaces it */
+void
+MotionPlanner::add_edge(const Point &a, const Point &b, double weight, bool crossing)
+{
+    PendingEdge edge;
+    edge.a = this->node(a);
+    edge.b = this->node(b);
+    if (edge.a == edge.b) return;
+    if (edge.a > edge.b) std::swap(edge.a, edge.b);
+    edge.weight = weight;
+    edge.crossing = crossing;
+    this->pending.push_back(edge);
+}
+
+/* connects all the points of the expolygon which see each other */
+void
+MotionPlanner::add_expolygon(const ExPolygon &expolygon, bool crosses_perimeter)
+{
+    Points points;
+    append_points(ExPolygons(1, expolygon), points);
+    
+    Lines lines;
+    lines.reserve(points.size() * (points.size() - 1) / 2);
+    for (size_t i = 0; i < points.size(); ++i) {
+        for (size_t j = i + 1; j < points.size(); ++j)
+            lines.push_back(Line(points[i], points[j]));
+    }
+    
+    // test all the lines at once so that the expolygon is indexed only once
+    std::vector<bool> contained;
+    expolygon.contains_lines(lines, contained);
+    const double factor = crosses_perimeter ? MP_CROSSING_FACTOR : 1;
+    for (size_t k = 0; k < lines.size(); ++k) {
+        if (contained[k]) this->add_edge(lines[k].a, lines[k].b, lines[k].length() * factor, crosses_perimeter);
+    }
+}
+
+/* Connects the vertices of distinct polygons by the lines which don't enter
+   any of the polygons. These are the lines lying in the free space around
+   them, which is indexed once so that each test only visits nearby edges. */
+void
+MotionPlanner::add_visible_pairs(const Polygons &polygons, double factor, bool crossing)
+{
+    if (polygons.size() < 2) return;
+    
+    BoundingBox bb;
+    for (Polygons::const_iterator p = polygons.begin(); p != polygons.end(); ++p)
+        bb.merge(p->points);
+    bb.offset(1);
+    Polygon box;
+    bb.polygon(&box);
+    ExPolygons free_space;
+    diff(Polygons(1, box), polygons, free_space, false);
+    ExPolygonCollectionIndex index(free_space);
+    
+    for (Polygons::const_iterator p = polygons.begin(); p != polygons.end(); ++p) {
+        for (Polygons::const_iterator q = p + 1; q != polygons.end(); ++q) {
+            for (Points::const_iterator a = p->points.begin(); a != p->points.end(); ++a) {
+                for (Points::const_iterator b = q->points.begin(); b != q->points.end(); ++b) {
+                    const Line line(*a, *b);
+                    if (index.contains_line(line)) this->add_edge(*a, *b, line.length() * factor, crossing);
+                }
+            }
+        }
+    }
+}
+
+bool
+MotionPlanner::edge_order(const PendingEdge &e1, const PendingEdge &e2)
+{
+    return e1.a < e2.a || (e1.a == e2.a && e1.b < e2.b);
+}
+
+/* packs the edges in adjacency arrays, keeping the last one added between
+   any two nodes */
+void
+MotionPlanner::build_graph()
+{
+    std::stable_sort(this->pending.begin(), this->pending.end(), MotionPlanner::edge_order);
+    std::vector<PendingEdge> unique;
+    for (size_t k = 0; k < this->pending.size(); ++k) {
+        if (k + 1 < this->pending.size()
+            && this->pending[k+1].a == this->pending[k].a && this->pending[k+1].b == this->pending[k].b)
+            continue;
+        unique.push_back(this->pending[k]);
+    }
+    std::vector<PendingEdge>().swap(this->pending);
+    
+    this->first_edge.assign(this->nodes.size() + 1, 0);
+    for (std::vector<PendingEdge>::const_iterator e = unique.begin(); e != unique.end(); ++e) {
+        ++this->first_edge[e->a + 1];
+        ++this->first_edge[e->b + 1];
+    }
+    for (size_t i = 0; i < this->nodes.size(); ++i)
+        this->first_edge[i+1] += this->first_edge[i];
+    
+    std::vector<size_t> next(this->first_edge.begin(), this->first_edge.end() - 1);
+    this->edges.resize(unique.size() * 2);
+    for (std::vector<PendingEdge>::const_iterator e = unique.begin(); e != unique.end(); ++e) {
+        Edge edge;
+        edge.weight   = e->weight;
+        edge.crossing = e->crossing;
+        edge.to = e->b;
+        this->edges[ next[e->a]++ ] = edge;
+        edge.to = e->a;
+        this->edges[ next[e->b]++ ] = edge;
+    }
+}
+
+static Point
+nearest_point(const Point &point, Points &candidates)
+{
+    if (candidates.empty()) return point;
+    return candidates[ point.nearest_point_index(candidates) ];
+}
+
+/* For optimal pathing, we should check visibility from point to all the
+   candidates, and then choose the one that is nearest to the other end among
+   the visible ones; however this is probably too slow. */
+Point
+MotionPlanner::find_node(const Point &point) const
+{
+    // if we're inside a hole, move to a point on hole
+    for (std::vector<ExPolygons>::const_iterator i = this->inner.begin(); i != this->inner.end(); ++i) {
+        for (ExPolygons::const_iterator ex = i->begin(); ex != i->end(); ++ex) {
+            for (Polygons::const_iterator hole = ex->holes.begin(); hole != ex->holes.end(); ++hole) {
+                if (!hole->contains_point(&point)) continue;
+                Points candidates = hole->points;
+                return nearest_point(point, candidates);
+            }
+        }
+    }
+    
+    // if we're inside an expolygon move to a point on contour or holes
+    for (std::vector<ExPolygons>::const_iterator i = this->inner.begin(); i != this->inner.end(); ++i) {
+        for (ExPolygons::const_iterator ex = i->begin(); ex != i->end(); ++ex) {
+            if (!ex->contains_point(&point)) continue;
+            Points candidates;
+            append_points(ExPolygons(1, *ex), candidates);
+            return nearest_point(point, candidates);
+        }
+    }
+    
+    // look for the island whose outer boundary contains our point
+    long idx = -1;
+    for (size_t i = 0; i < this->islands.size() && idx == -1; ++i) {
+        if (!this->no_internal) {
+            for (ExPolygons::const_iterator ex = this->contours_ex[i].begin(); ex != this->contours_ex[i].end(); ++ex) {
+                if (ex->contour.contains_point(&point)) idx = i;
+            }
+        } else {
+            for (Polygons::const_iterator p = this->outer[i].begin(); p != this->outer[i].end(); ++p) {
+                if (p->contains_point(&point)) idx = i;
+            }
+        }
+    }
+    
+    Points candidates;
+    if (idx != -1) {
+        for (ExPolygons::const_iterator ex = this->inner[idx].begin(); ex != this->inner[idx].end(); ++ex)
+            candidates.insert(candidates.end(), ex->contour.points.begin(), ex->contour.points.end());
+        if (candidates.empty()) append_points(this->outer[idx], candidates);
+    } else {
+        for (std::vector<Polygons>::const_iterator i = this->outer.begin(); i != this->outer.end(); ++i)
+            append_points(*i, candidates);
+    }
+    return nearest_point(point, candidates);
+}
+
+/* A* search from the node nearest to from towards the one nearest to to.
+   Weights are never shorter than the straight distance, which is thus a
+   consistent estimate of the remaining cost. */
+void
+MotionPlanner::shortest_path(const Point &from, const Point &to, Polyline* polyline)
+{
+    polyline->points.clear();
+    this->last_crossings = 0;
+    polyline->points.push_back(from);
+    if (this->islands.empty()) {
+        polyline->points.push_back(to);
+        return;
+    }
+    
+    // find nearest nodes
+    const Point new_from = this->find_node(from);
+    const Point new_to   = this->find_node(to);
+    polyline->points.push_back(new_from);
+    
+    const size_t root = this->node(new_from), target = this->node(new_to);
+    const size_t none = (size_t)-1;
+    if (root < this->nodes.size() && target < this->nodes.size() && root != target
+        && this->nodes[root].coincides_with(new_from) && this->nodes[target].coincides_with(new_to)) {
+        std::vector<double> dist(this->nodes.size(), std::numeric_limits<double>::infinity());
+        std::vector<size_t> prev(this->nodes.size(), none);
+        std::vector<bool> solved(this->nodes.size(), false);
+        typedef std::pair<double,size_t> QueueItem;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+        dist[root] = 0;
+        queue.push(QueueItem(new_from.distance_to(&new_to), root));
+        while (!queue.empty()) {
+            const size_t n = queue.top().second;
+            queue.pop();
+            if (solved[n]) continue;
+            solved[n] = true;
+            if (n == target) break;
+            for (size_t e = this->first_edge[n]; e < this->first_edge[n+1]; ++e) {
+                const Edge &edge = this->edges[e];
+                const double d = dist[n] + edge.weight;
+                if (solved[edge.to] || d >= dist[edge.to]) continue;
+                dist[edge.to] = d;
+                prev[edge.to] = n;
+                queue.push(QueueItem(d + this->nodes[edge.to].distance_to(&new_to), edge.to));
+            }
+        }
+        
+        if (prev[target] != none) {
+            const size_t first = polyline->points.size();
+            for (size_t n = target; prev[n] != none; n = prev[n]) {
+                polyline->points.push_back(this->nodes[n]);
+                for (size_t e = this->first_edge[n]; e < this->first_edge[n+1]; ++e) {
+                    if (this->edges[e].to == prev[n] && this->edges[e].crossing) ++this->last_crossings;
+                }
+            }
+            std::reverse(polyline->points.begin() + first, polyline->points.end());
+        }
+    }
+    
+    polyline->points.push_back(to);
+}
+
+}
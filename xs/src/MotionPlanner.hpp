@@ -0,0 +1,67 @@
+#ifndef slic3r_MotionPlanner_hpp_
+#define slic3r_MotionPlanner_hpp_
+
+#include <myinit.h>
+#include "ExPolygon.hpp"
+#include "Polyline.hpp"
+#include <vector>
+
+// clearance from the perimeters
+#define MP_INNER_MARGIN scale_(0.5)
+#define MP_OUTER_MARGIN scale_(2)
+
+/* This factor weighs the crossing of a perimeter vs. the alternative path:
+   a value of 5 means that a perimeter will be crossed if the alternative
+   path is >= 5x the length of the straight line we could follow if we
+   decided to cross the perimeter. A nearly-infinite value only permits
+   perimeter crossing when there's no alternative path. */
+#define MP_CROSSING_FACTOR 20
+
+namespace Slic3r {
+
+/* Travel planner avoiding perimeter crossings. Paths are searched in a
+   visibility graph whose nodes are the vertices of the islands offset inwards
+   (for moves within an island) and outwards (for moves between islands).
+   The graph is built once, so the same planner should answer all the travels
+   of a layer. */
+class MotionPlanner
+{
+    public:
+    size_t last_crossings;  // perimeters crossed by the last path returned
+    MotionPlanner(const ExPolygons &_islands, bool _no_internal = false);
+    void shortest_path(const Point &from, const Point &to, Polyline* polyline);
+    
+    private:
+    struct Edge
+    {
+        size_t to;
+        double weight;
+        bool crossing;
+    };
+    struct PendingEdge
+    {
+        size_t a, b;  // a < b
+        double weight;
+        bool crossing;
+    };
+    bool no_internal;
+    ExPolygons islands;
+    std::vector<ExPolygons> inner;        // islands offset inwards
+    std::vector<Polygons> outer;          // island contours offset outwards
+    std::vector<ExPolygons> contours_ex;  // outer minus inner contours, covering the perimeters
+    Points nodes;                         // sorted and unique
+    std::vector<size_t> first_edge;       // edges of node i are first_edge[i] .. first_edge[i+1]-1
+    std::vector<Edge> edges;
+    std::vector<PendingEdge> pending;
+    size_t node(const Point &point) const;
+    void add_edge(const Point &a, const Point &b, double weight, bool crossing);
+    void add_expolygon(const ExPolygon &expolygon, bool crosses_perimeter);
+    void add_visible_pairs(const Polygons &polygons, double factor, bool crossing);
+    static bool edge_order(const PendingEdge &e1, const PendingEdge &e2);
+    void build_graph();
+    Point find_node(const Point &point) const;
+};
+
+}
+
+#endif
@@ -32,10 +32,16 @@ MultiPoint::reverse()
     std::reverse(this->points.begin(), this->points.end());
 }
 
-Point*
+Point
 MultiPoint::first_point() const
 {
-    return new Point(this->points.front());
+    return this->points.front();
+}
+
+BoundingBox
+MultiPoint::bounding_box() const
+{
+    return BoundingBox(this->points);
 }
 
 double
@@ -55,39 +61,90 @@ MultiPoint::is_valid() const
     return this->points.size() >= 2;
 }
 
+/* returns the index of the point strictly between first and last which is
+   farthest from the segment joining them (first if there is none) and stores
+   its distance in dmax; the segment is set up once and the inner loop only
+   compares integer cross products, dividing by the length just for the winner */
+static size_t
+farthest_from_segment(const Points &points, size_t first, size_t last, double &dmax)
+{
+    const Point &a = points[first];
+    const Point &b = points[last];
+    size_t index = first;
+    dmax = 0;
+    if (a.coincides_with(b)) {
+        for (size_t i = first + 1; i < last; ++i) {
+            double d = points[i].distance_to(&a);
+            if (d > dmax) {
+                index = i;
+                dmax = d;
+            }
+        }
+        return index;
+    }
+    
+    // the cross product of two scaled vectors overflows a long
+    const coord2_t dx = (coord2_t)b.x - a.x;
+    const coord2_t dy = (coord2_t)b.y - a.y;
+    coord2_t nmax = 0;
+    for (size_t i = first + 1; i < last; ++i) {
+        coord2_t n = dx * ((coord2_t)a.y - points[i].y) - ((coord2_t)a.x - points[i].x) * dy;
+        if (n < 0) n = -n;
+        if (n > nmax) {
+            index = i;
+            nmax = n;
+        }
+    }
+    dmax = (double)nmax / a.distance_to(&b);
+    return index;
+}
+
 Points
 MultiPoint::_douglas_peucker(const Points &points, const double tolerance)
 {
     Points results;
-    double dmax = 0;
-    size_t index = 0;
-    Line full(points.front(), points.back());
-    for (Points::const_iterator it = points.begin() + 1; it != points.end(); ++it) {
-        double d = it->distance_to(full);
-        if (d > dmax) {
-            index = it - points.begin();
-            dmax = d;
-        }
+    MultiPoint::_douglas_peucker(points, tolerance, results);
+    return results;
+}
+
+/* The ranges still to be examined are kept on an explicit stack and the points
+   to keep are only marked, so no sub-range is ever copied; the output is
+   assembled in a single pass at the end. */
+void
+MultiPoint::_douglas_peucker(const Points &points, const double tolerance, Points &retval)
+{
+    retval.clear();
+    if (points.size() < 3) {
+        retval = points;
+        return;
     }
-    if (dmax >= tolerance) {
-        Points dp0;
-        dp0.reserve(index + 1);
-        dp0.insert(dp0.end(), points.begin(), points.begin() + index + 1);
-        Points dp1 = MultiPoint::_douglas_peucker(dp0, tolerance);
-        results.reserve(results.size() + dp1.size() - 1);
-        results.insert(results.end(), dp1.begin(), dp1.end() - 1);
+    
+    std::vector<bool> keep(points.size(), false);
+    keep.front() = keep.back() = true;
+    size_t kept = 2;
+    
+    std::vector<std::pair<size_t,size_t> > ranges;
+    ranges.push_back(std::make_pair(0, points.size() - 1));
+    while (!ranges.empty()) {
+        const size_t first = ranges.back().first;
+        const size_t last  = ranges.back().second;
+        ranges.pop_back();
+        if (last - first < 2) continue;
         
-        dp0.clear();
-        dp0.reserve(points.size() - index + 1);
-        dp0.insert(dp0.end(), points.begin() + index, points.end());
-        dp1 = MultiPoint::_douglas_peucker(dp0, tolerance);
-        results.reserve(results.size() + dp1.size());
-        results.insert(results.end(), dp1.begin(), dp1.end());
-    } else {
-        results.push_back(points.front());
-        results.push_back(points.back());
+        double dmax;
+        size_t index = farthest_from_segment(points, first, last, dmax);
+        if (index != first && dmax >= tolerance) {
+            keep[index] = true;
+            ++kept;
+            ranges.push_back(std::make_pair(first, index));
+            ranges.push_back(std::make_pair(index, last));
+        }
+    }
+    
+    retval.reserve(kept);
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (keep[i]) retval.push_back(points[i]);
     }
-    return results;
 }
 
 #ifdef SLIC3RXS
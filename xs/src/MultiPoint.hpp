@@ -1,6 +1,7 @@
 #ifndef slic3r_MultiPoint_hpp_
 #define slic3r_MultiPoint_hpp_
 
+#include "BoundingBox.hpp"
 #include "Line.hpp"
 #include "Point.hpp"
 #include <algorithm>
@@ -16,12 +17,14 @@ class MultiPoint
     void translate(double x, double y);
     void rotate(double angle, Point* center);
     void reverse();
-    Point* first_point() const;
-    virtual Point* last_point() const = 0;
+    Point first_point() const;
+    virtual Point last_point() const = 0;
     virtual Lines lines() const = 0;
     double length() const;
+    BoundingBox bounding_box() const;
     bool is_valid() const;
     static Points _douglas_peucker(const Points &points, const double tolerance);
+    static void _douglas_peucker(const Points &points, const double tolerance, Points &retval);
     
     #ifdef SLIC3RXS
     void from_SV(SV* poly_sv);
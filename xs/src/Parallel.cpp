@@ -0,0 +1,144 @@
+#include "Parallel.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+
+namespace Slic3r {
+
+unsigned int
+hardware_threads()
+{
+    #ifdef _SC_NPROCESSORS_ONLN
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0) return (unsigned int)n;
+    #endif
+    return 1;
+}
+
+ThreadCounter::ThreadCounter()
+    : _retired(0)
+{
+    pthread_key_create(&this->_key, ThreadCounter::retire);
+}
+
+ThreadCounter::~ThreadCounter()
+{
+    pthread_key_delete(this->_key);
+    for (std::vector<Slot*>::iterator it = this->_slots.begin(); it != this->_slots.end(); ++it)
+        delete *it;
+}
+
+ThreadCounter::Slot*
+ThreadCounter::slot()
+{
+    Slot* slot = static_cast<Slot*>(pthread_getspecific(this->_key));
+    if (slot == NULL) {
+        slot = new Slot;
+        slot->owner = this;
+        slot->count = 0;
+        pthread_setspecific(this->_key, slot);
+        MutexLock lock(this->_mutex);
+        this->_slots.push_back(slot);
+    }
+    return slot;
+}
+
+/* called on thread exit: keeps the count of the thread in the total */
+void
+ThreadCounter::retire(void* obj)
+{
+    Slot* slot = static_cast<Slot*>(obj);
+    ThreadCounter* owner = slot->owner;
+    {
+        MutexLock lock(owner->_mutex);
+        owner->_retired += slot->count;
+        owner->_slots.erase(std::find(owner->_slots.begin(), owner->_slots.end(), slot));
+    }
+    delete slot;
+}
+
+size_t
+ThreadCounter::sum()
+{
+    MutexLock lock(this->_mutex);
+    size_t total = this->_retired;
+    for (std::vector<Slot*>::const_iterator it = this->_slots.begin(); it != this->_slots.end(); ++it)
+        total += (*it)->count;
+    return total;
+}
+
+void
+ThreadCounter::reset()
+{
+    MutexLock lock(this->_mutex);
+    this->_retired = 0;
+    for (std::vector<Slot*>::iterator it = this->_slots.begin(); it != this->_slots.end(); ++it)
+        (*it)->count = 0;
+}
+
+/* state shared by all the worker threads of a parallelize() call */
+class ParallelQueue
+{
+    public:
+    ParallelJob* job;
+    size_t next;
+    size_t count;
+    bool failed;
+    std::string error;
+    Mutex mutex;
+    ParallelQueue(ParallelJob* _job, size_t _count)
+        : job(_job), next(0), count(_count), failed(false) {};
+};
+
+static void*
+parallel_worker(void* arg)
+{
+    ParallelQueue* queue = (ParallelQueue*)arg;
+    while (1) {
+        size_t idx;
+        {
+            MutexLock lock(queue->mutex);
+            if (queue->failed || queue->next >= queue->count) break;
+            idx = queue->next++;
+        }
+        try {
+            queue->job->run(idx);
+        } catch (std::exception &e) {
+            MutexLock lock(queue->mutex);
+            queue->failed = true;
+            queue->error  = e.what();
+        } catch (...) {
+            MutexLock lock(queue->mutex);
+            queue->failed = true;
+            queue->error  = "unknown exception in parallel job";
+        }
+    }
+    return NULL;
+}
+
+void
+parallelize(ParallelJob &job, size_t count, unsigned int threads_count)
+{
+    if (count == 0) return;
+    if (threads_count == 0) threads_count = hardware_threads();
+    if (threads_count > count) threads_count = count;
+
+    ParallelQueue queue(&job, count);
+
+    // the calling thread works too, so we only spawn threads_count - 1 threads
+    std::vector<pthread_t> threads;
+    threads.reserve(threads_count - 1);
+    for (unsigned int i = 1; i < threads_count; i++) {
+        pthread_t th;
+        if (pthread_create(&th, NULL, parallel_worker, &queue) != 0) break;  // run with what we have
+        threads.push_back(th);
+    }
+    parallel_worker(&queue);
+    for (std::vector<pthread_t>::iterator it = threads.begin(); it != threads.end(); ++it)
+        pthread_join(*it, NULL);
+
+    if (queue.failed) throw std::runtime_error(queue.error);
+}
+
+}
@@ -0,0 +1,110 @@
+#ifndef slic3r_Parallel_hpp_
+#define slic3r_Parallel_hpp_
+
+#include <myinit.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+namespace Slic3r {
+
+class Mutex
+{
+    public:
+    Mutex() { pthread_mutex_init(&this->_mutex, NULL); };
+    ~Mutex() { pthread_mutex_destroy(&this->_mutex); };
+    void lock() { pthread_mutex_lock(&this->_mutex); };
+    void unlock() { pthread_mutex_unlock(&this->_mutex); };
+
+    private:
+    pthread_mutex_t _mutex;
+    Mutex(const Mutex &);
+    Mutex& operator=(const Mutex &);
+};
+
+/* locks the supplied mutex for the lifetime of this object */
+class MutexLock
+{
+    public:
+    explicit MutexLock(Mutex &mutex) : _mutex(mutex) { this->_mutex.lock(); };
+    ~MutexLock() { this->_mutex.unlock(); };
+
+    private:
+    Mutex &_mutex;
+    MutexLock(const MutexLock &);
+    MutexLock& operator=(const MutexLock &);
+};
+
+/* one lazily constructed instance of T for each native thread (Perl ithreads
+   included); instances are deleted when their thread exits */
+template <class T>
+class ThreadLocal
+{
+    public:
+    ThreadLocal() { pthread_key_create(&this->_key, ThreadLocal<T>::destroy); };
+    ~ThreadLocal() { pthread_key_delete(this->_key); };
+    T* get()
+    {
+        T* obj = static_cast<T*>(pthread_getspecific(this->_key));
+        if (obj == NULL) {
+            obj = new T();
+            pthread_setspecific(this->_key, obj);
+        }
+        return obj;
+    };
+
+    private:
+    pthread_key_t _key;
+    static void destroy(void* obj) { delete static_cast<T*>(obj); };
+    ThreadLocal(const ThreadLocal &);
+    ThreadLocal& operator=(const ThreadLocal &);
+};
+
+/* a counter that each native thread increments on a copy of its own, so
+   that hot paths don't contend on a mutex; the copies of exited threads are
+   folded into a total. sum() and reset() lock, and are exact once the
+   counting threads are done. */
+class ThreadCounter
+{
+    public:
+    ThreadCounter();
+    ~ThreadCounter();
+    void increment() { ++this->slot()->count; };
+    size_t sum();
+    void reset();
+
+    private:
+    struct Slot
+    {
+        ThreadCounter* owner;
+        size_t count;
+    };
+    pthread_key_t _key;
+    Mutex _mutex;
+    std::vector<Slot*> _slots;  // of the live threads
+    size_t _retired;            // counted by exited threads
+    Slot* slot();
+    static void retire(void* slot);
+    ThreadCounter(const ThreadCounter &);
+    ThreadCounter& operator=(const ThreadCounter &);
+};
+
+/* A ParallelJob is a set of independent work items identified by their index.
+   run() is called from native worker threads, so it must never touch the Perl
+   interpreter (no CONFESS, no SV handling). */
+class ParallelJob
+{
+    public:
+    virtual ~ParallelJob() {};
+    virtual void run(size_t idx) = 0;
+};
+
+unsigned int hardware_threads();
+
+/* calls job.run(i) for each i in [0, count) using up to threads_count native
+   threads (0 means one per available core); returns when all items are done */
+void parallelize(ParallelJob &job, size_t count, unsigned int threads_count = 0);
+
+}
+
+#endif
@@ -0,0 +1,305 @@
+#include "PerimeterGenerator.hpp"
+#include "ClipperUtils.hpp"
+#include "Fill.hpp"
+#include "Geometry.hpp"
+#include <algorithm>
+
+namespace Slic3r {
+
+PerimeterGenerator::PerimeterGenerator(const SurfaceCollection &_slices, double _perimeter_width,
+    double _perimeter_spacing, double _solid_infill_spacing, double _flow_spacing,
+    int _perimeters, bool _thin_walls, bool _gap_fill, bool _outer_first)
+    : slices(_slices), perimeter_width(_perimeter_width), perimeter_spacing(_perimeter_spacing),
+      solid_infill_spacing(_solid_infill_spacing), flow_spacing(_flow_spacing),
+      perimeters(_perimeters), thin_walls(_thin_walls), gap_fill(_gap_fill), outer_first(_outer_first)
+{}
+
+/* Appends the perimeters to loops and the infill boundaries to fill_surfaces;
+   the gaps are left in this->gaps. */
+void
+PerimeterGenerator::process(ExtrusionEntityCollection &loops, SurfaceCollection &fill_surfaces)
+{
+    const double pwidth   = this->perimeter_width;
+    const double pspacing = this->perimeter_spacing;
+    const double ispacing = this->solid_infill_spacing;
+    const double gap_area_threshold = pwidth * pwidth;
+    
+    this->gaps.clear();
+    Polygons contours;      // ccw
+    Polygons holes;         // cw
+    ExPolygons thin_walls;
+    
+    // we need to process each island separately because we might have different
+    // extra perimeters for each one
+    for (Surfaces::const_iterator surface = this->slices.surfaces.begin(); surface != this->slices.surfaces.end(); ++surface) {
+        const int loop_number = this->perimeters + surface->extra_perimeters;
+    
+        Polygons last = surface->expolygon;
+        ExPolygons last_gaps;
+        for (int i = 1; i <= loop_number; ++i) {  // outer loop is 1
+            Polygons offsets;
+            if (i == 1) {
+                // the minimum thickness of a single loop is:
+                // width/2 + spacing/2 + spacing/2 + width/2
+                offset2(last, offsets, -(0.5*pwidth + 0.5*pspacing - 1), +(0.5*pspacing - 1));
+    
+                // look for thin walls
+                if (this->thin_walls) {
+                    Polygons grown;
+                    offset(offsets, grown, +0.5*pwidth);
+                    ExPolygons diff_ex;
+                    diff(last, grown, diff_ex, false);
+                    Geometry::filter_by_min_area(diff_ex, gap_area_threshold);
+                    thin_walls.insert(thin_walls.end(), diff_ex.begin(), diff_ex.end());
+                }
+            } else {
+                offset2(last, offsets, -(1.5*pspacing - 1), +(0.5*pspacing - 1));
+    
+                // look for gaps
+                if (this->gap_fill) {
+                    Polygons shrunk, grown;
+                    offset(last, shrunk, -0.5*pspacing);
+                    offset(offsets, grown, +0.5*pspacing);
+                    last_gaps.clear();
+                    diff(shrunk, grown, last_gaps, false);
+                    Geometry::filter_by_min_area(last_gaps, gap_area_threshold);
+                    this->gaps.insert(this->gaps.end(), last_gaps.begin(), last_gaps.end());
+                }
+            }
+    
+            if (offsets.empty()) break;
+            last = offsets;
+            for (Polygons::const_iterator polygon = offsets.begin(); polygon != offsets.end(); ++polygon) {
+                if (polygon->is_counter_clockwise()) {
+                    contours.push_back(*polygon);
+                } else {
+                    holes.push_back(*polygon);
+                }
+            }
+        }
+    
+        // make sure we don't infill narrow parts that are already gap-filled
+        // (we only consider this surface's gaps to reduce the diff() complexity)
+        Polygons gap_polygons;
+        for (ExPolygons::const_iterator gap = last_gaps.begin(); gap != last_gaps.end(); ++gap) {
+            Polygons pp = *gap;
+            gap_polygons.insert(gap_polygons.end(), pp.begin(), pp.end());
+        }
+        Polygons not_filled;
+        diff(last, gap_polygons, not_filled, false);
+    
+        // create one more offset to be used as boundary for fill
+        // we offset by half the perimeter spacing (to get to the actual infill boundary)
+        // and then we offset back and forth by half the infill spacing to only consider the
+        // non-collapsing regions
+        ExPolygons not_filled_ex;
+        union_(not_filled, not_filled_ex);
+        Polygons simplified;
+        for (ExPolygons::const_iterator ex = not_filled_ex.begin(); ex != not_filled_ex.end(); ++ex) {
+            Polygons pp = ex->simplify_p(SCALED_RESOLUTION);
+            simplified.insert(simplified.end(), pp.begin(), pp.end());
+        }
+        ExPolygons fill_boundaries;
+        offset2_ex(simplified, fill_boundaries, -(pspacing/2 + ispacing/2), +ispacing/2);
+        for (ExPolygons::const_iterator ex = fill_boundaries.begin(); ex != fill_boundaries.end(); ++ex) {
+            Surface s;
+            s.expolygon         = *ex;
+            s.surface_type      = stInternal;
+            s.thickness         = -1;
+            s.thickness_layers  = 1;
+            s.bridge_angle      = -1;
+            s.extra_perimeters  = 0;
+            fill_surfaces.surfaces.push_back(s);
+        }
+    }
+    
+    // find nesting hierarchies separately for contours and holes
+    ClipperLib::PolyTree contours_pt, holes_pt;
+    union_pt(contours, contours_pt);
+    union_pt(holes, holes_pt);
+    
+    // order loops from inner to outer (in terms of object slices)
+    ExtrusionEntitiesPtr ordered;
+    this->traverse(contours_pt.Childs, 0, true, holes_pt.Childs, ordered);
+    if (this->outer_first) std::reverse(ordered.begin(), ordered.end());
+    loops.entities.insert(loops.entities.end(), ordered.begin(), ordered.end());
+    
+    // thin walls are extruded along their medial axis as external perimeters
+    if (!thin_walls.empty()) {
+        ExtrusionEntityCollection walls;
+        for (ExPolygons::const_iterator wall = thin_walls.begin(); wall != thin_walls.end(); ++wall) {
+            Polylines polylines;
+            Polygons polygons;
+            wall->medial_axis(pspacing, polylines, polygons);
+            for (Polylines::const_iterator p = polylines.begin(); p != polylines.end(); ++p) {
+                if (p->length() <= pspacing * 2) continue;
+                ExtrusionPath* path = new ExtrusionPath;
+                path->polyline      = *p;
+                path->role          = erExternalPerimeter;
+                path->height        = -1;
+                path->flow_spacing  = this->flow_spacing;
+                walls.entities.push_back(path);
+            }
+            for (Polygons::const_iterator p = polygons.begin(); p != polygons.end(); ++p) {
+                if (p->length() <= pspacing * 2) continue;
+                ExtrusionLoop* loop = new ExtrusionLoop;
+                loop->polygon       = *p;
+                loop->role          = erExternalPerimeter;
+                loop->height        = -1;
+                loop->flow_spacing  = this->flow_spacing;
+                walls.entities.push_back(loop);
+            }
+        }
+    
+        // the chained collection holds copies, which are handed over to loops
+        ExtrusionEntityCollection* chained = walls.chained_path(false);
+        loops.entities.insert(loops.entities.end(), chained->entities.begin(), chained->entities.end());
+        delete chained;
+        for (ExtrusionEntitiesPtr::iterator it = walls.entities.begin(); it != walls.entities.end(); ++it)
+            delete *it;
+    }
+}
+
+/* Fills the gaps found by process() with solid rectilinear infill, one width
+   class after the other: widths are the scaled extrusion widths of the classes,
+   from the largest one, and spacings their unscaled flow spacings. Each class
+   takes the parts of the remaining gaps which don't collapse when shrunk by
+   half its width. Lines are laid at the given angle (in radians) around the
+   center of each area and split into single segments, so that the final
+   chained_path() search can enter each of them from its nearest end.
+   Gaps aren't extruded along their medial axis like thin walls: an
+   ExtrusionPath has a single flow_spacing, so a medial axis path couldn't
+   follow the varying width of a gap, while the width classes bound the
+   over and under extrusion of the zigzag. */
+void
+PerimeterGenerator::fill_gaps(ExtrusionEntityCollection &thin_fills, const std::vector<double> &widths,
+    const std::vector<double> &spacings, double angle, double height) const
+{
+    ExPolygons gaps = this->gaps;
+    for (size_t i = 0; i < widths.size() && !gaps.empty(); ++i) {
+        const double width = widths[i];
+    
+        // extract the gaps having this width
+        ExPolygons this_width;
+        Polygons this_width_pp;
+        for (ExPolygons::const_iterator gap = gaps.begin(); gap != gaps.end(); ++gap) {
+            ExPolygons shrunk;
+            offset_ex((Polygons)*gap, shrunk, -0.5*width + 1);
+            for (ExPolygons::const_iterator s = shrunk.begin(); s != shrunk.end(); ++s) {
+                ExPolygons grown;
+                offset_ex((Polygons)*s, grown, +0.5*width);
+                this_width.insert(this_width.end(), grown.begin(), grown.end());
+            }
+        }
+    
+        for (ExPolygons::const_iterator ex = this_width.begin(); ex != this_width.end(); ++ex) {
+            Polygons pp = *ex;
+            this_width_pp.insert(this_width_pp.end(), pp.begin(), pp.end());
+    
+            // since this is infill, we have to offset by half-extrusion width inwards
+            ExPolygons infill;
+            offset_ex(pp, infill, -0.5*width);
+            for (ExPolygons::iterator expolygon = infill.begin(); expolygon != infill.end(); ++expolygon) {
+                // rotate polygons so that we can work with vertical lines
+                Point center = expolygon->bounding_box().center();
+                expolygon->rotate(angle, &center);
+                expolygon->translate(center.x, center.y);
+                // gaps seldom repeat across layers, so keep them out of the infill cache
+                Polylines polylines;
+                const double line_spacing = Fill::rectilinear(*expolygon, scale_(spacings[i]), 1,
+                    false, false, false, polylines, false);
+    
+                for (Polylines::iterator polyline = polylines.begin(); polyline != polylines.end(); ++polyline) {
+                    polyline->translate(-center.x, -center.y);
+                    polyline->rotate(-angle, &center);
+                    Lines lines = polyline->lines();
+                    for (Lines::const_iterator line = lines.begin(); line != lines.end(); ++line) {
+                        ExtrusionPath* path = new ExtrusionPath;
+                        path->polyline.points.push_back(line->a);
+                        path->polyline.points.push_back(line->b);
+                        path->role          = erGapFill;
+                        path->height        = height;
+                        // solid infill spacing was adjusted to the gap width
+                        path->flow_spacing  = unscale(line_spacing);
+                        thin_fills.entities.push_back(path);
+                    }
+                }
+            }
+        }
+    
+        // check what's left
+        Polygons gaps_pp;
+        for (ExPolygons::const_iterator gap = gaps.begin(); gap != gaps.end(); ++gap) {
+            Polygons pp = *gap;
+            gaps_pp.insert(gaps_pp.end(), pp.begin(), pp.end());
+        }
+        gaps.clear();
+        diff(gaps_pp, this_width_pp, gaps, false);
+    }
+}
+
+/* Appends the loops of the given nodes and of their descendants, children
+   first, ordering siblings by nearest neighbor. Each outermost contour is
+   preceded by the loops of the holes it contains, which are removed from the
+   candidates; external perimeters are the outermost contours and the
+   innermost hole loops. */
+void
+PerimeterGenerator::traverse(ClipperLib::PolyNodes &nodes, int depth, bool is_contour,
+    ClipperLib::PolyNodes &holes, ExtrusionEntitiesPtr &retval) const
+{
+    // use a nearest neighbor search to order these children
+    Points ordering_points;
+    ordering_points.reserve(nodes.size());
+    for (ClipperLib::PolyNodes::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+        ordering_points.push_back(Point((*it)->Contour.front().X, (*it)->Contour.front().Y));
+    ClipperLib::PolyNodes ordered_nodes;
+    Geometry::chained_path_items(ordering_points, nodes, ordered_nodes);
+    
+    for (ClipperLib::PolyNodes::iterator it = ordered_nodes.begin(); it != ordered_nodes.end(); ++it) {
+        Polygon polygon;
+        ClipperPath_to_Slic3rMultiPoint((*it)->Contour, polygon);
+    
+        // if this is the outermost loop of an island, prepend the loops of its holes
+        if (is_contour && depth == 0) {
+            ClipperLib::PolyNodes island_holes;
+            for (ClipperLib::PolyNodes::iterator hole = holes.begin(); hole != holes.end();) {
+                const Point first_point((*hole)->Contour.front().X, (*hole)->Contour.front().Y);
+                if (polygon.contains_point(&first_point)) {
+                    island_holes.push_back(*hole);
+                    hole = holes.erase(hole);
+                } else {
+                    ++hole;
+                }
+            }
+            ExtrusionEntitiesPtr hole_loops;
+            for (ClipperLib::PolyNodes::iterator hole = island_holes.begin(); hole != island_holes.end(); ++hole) {
+                ClipperLib::PolyNodes hole_nodes(1, *hole);
+                this->traverse(hole_nodes, 0, false, holes, hole_loops);
+            }
+            retval.insert(retval.end(), hole_loops.rbegin(), hole_loops.rend());
+        }
+        this->traverse((*it)->Childs, depth + 1, is_contour, holes, retval);
+    
+        // return ccw contours and cw holes
+        // GCode.pm will convert all of them to ccw, but it needs to know
+        // what the holes are in order to compute the correct inwards move
+        if ((*it)->IsHole()) polygon.reverse();
+        if (!is_contour) polygon.reverse();
+    
+        ExtrusionLoop* loop = new ExtrusionLoop;
+        loop->polygon = polygon;
+        loop->role = erPerimeter;
+        if (is_contour ? depth == 0 : (*it)->Childs.empty()) {
+            // external perimeters are root level in case of contours
+            // and items with no children in case of holes
+            loop->role = erExternalPerimeter;
+        } else if (depth == 1 && is_contour) {
+            loop->role = erContourInternalPerimeter;
+        }
+        loop->height = -1;
+        loop->flow_spacing = this->flow_spacing;
+        retval.push_back(loop);
+    }
+}
+
+}
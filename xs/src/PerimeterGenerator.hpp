@@ -0,0 +1,47 @@
+#ifndef slic3r_PerimeterGenerator_hpp_
+#define slic3r_PerimeterGenerator_hpp_
+
+#include <myinit.h>
+#include "ExPolygon.hpp"
+#include "ExtrusionEntityCollection.hpp"
+#include "SurfaceCollection.hpp"
+#include "clipper.hpp"
+#include <vector>
+
+namespace Slic3r {
+
+/* Generates the perimeters of a layer region from its slices: the nested
+   loops of each island, the thin walls too narrow for a loop, the gaps left
+   between loops and the surfaces left for infill. Loops come out as ccw
+   contours and cw holes, ordered from inner to outer (in terms of object
+   slices) unless outer_first is set. Widths and spacings are scaled, while
+   flow_spacing is the unscaled perimeter spacing recorded in the extrusions.
+   The gaps are then filled by fill_gaps() with solid rectilinear infill. */
+class PerimeterGenerator
+{
+    public:
+    SurfaceCollection slices;
+    double perimeter_width;
+    double perimeter_spacing;
+    double solid_infill_spacing;
+    double flow_spacing;
+    int perimeters;           // loops of each island, besides its extra_perimeters
+    bool thin_walls;          // look for walls too thin for the outer loop
+    bool gap_fill;            // look for gaps between the loops
+    bool outer_first;         // reverse the order of the loops
+    ExPolygons gaps;          // found by the last process() call
+    PerimeterGenerator(const SurfaceCollection &_slices, double _perimeter_width,
+        double _perimeter_spacing, double _solid_infill_spacing, double _flow_spacing,
+        int _perimeters, bool _thin_walls, bool _gap_fill, bool _outer_first);
+    void process(ExtrusionEntityCollection &loops, SurfaceCollection &fill_surfaces);
+    void fill_gaps(ExtrusionEntityCollection &thin_fills, const std::vector<double> &widths,
+        const std::vector<double> &spacings, double angle, double height) const;
+    
+    private:
+    void traverse(ClipperLib::PolyNodes &nodes, int depth, bool is_contour,
+        ClipperLib::PolyNodes &holes, ExtrusionEntitiesPtr &retval) const;
+};
+
+}
+
+#endif
@@ -23,8 +23,8 @@ Point::rotate(double angle, Point* center)
 {
     double cur_x = (double)this->x;
     double cur_y = (double)this->y;
-    this->x = (long)round( (double)center->x + cos(angle) * (cur_x - (double)center->x) - sin(angle) * (cur_y - (double)center->y) );
-    this->y = (long)round( (double)center->y + cos(angle) * (cur_y - (double)center->y) + sin(angle) * (cur_x - (double)center->x) );
+    this->x = (coord_t)round( (double)center->x + cos(angle) * (cur_x - (double)center->x) - sin(angle) * (cur_y - (double)center->y) );
+    this->y = (coord_t)round( (double)center->y + cos(angle) * (cur_y - (double)center->y) + sin(angle) * (cur_x - (double)center->x) );
 }
 
 bool
@@ -100,8 +100,8 @@ Point::distance_to(const Line &line) const
 {
     if (line.a.coincides_with(&line.b)) return this->distance_to(&line.a);
     
-    double n = (line.b.x - line.a.x) * (line.a.y - this->y)
-        - (line.a.x - this->x) * (line.b.y - line.a.y);
+    double n = (coord2_t)(line.b.x - line.a.x) * (line.a.y - this->y)
+        - (coord2_t)(line.a.x - this->x) * (line.b.y - line.a.y);
     
     return std::abs(n) / line.length();
 }
@@ -116,7 +116,7 @@ Point::distance_to(const Line &line) const
 double
 Point::ccw(const Point &p1, const Point &p2) const
 {
-    return (p2.x - p1.x)*(this->y - p1.y) - (p2.y - p1.y)*(this->x - p1.x);
+    return (coord2_t)(p2.x - p1.x)*(this->y - p1.y) - (coord2_t)(p2.y - p1.y)*(this->x - p1.x);
 }
 
 double
@@ -155,6 +155,19 @@ Point::to_SV_pureperl() const {
     return newRV_noinc((SV*)av);
 }
 
+SV*
+points_to_SV_flat(const Points &points)
+{
+    AV* av = newAV();
+    if (!points.empty()) av_extend(av, 2 * points.size() - 1);
+    int i = 0;
+    for (Points::const_iterator it = points.begin(); it != points.end(); ++it) {
+        av_store(av, i++, newSViv(it->x));
+        av_store(av, i++, newSViv(it->y));
+    }
+    return newRV_noinc((SV*)av);
+}
+
 void
 Point::from_SV(SV* point_sv)
 {
@@ -174,6 +187,35 @@ Point::from_SV_check(SV* point_sv)
         this->from_SV(point_sv);
     }
 }
+
+void
+Pointf::from_SV(SV* point_sv)
+{
+    AV* point_av = (AV*)SvRV(point_sv);
+    this->x = SvNV(*av_fetch(point_av, 0, 0));
+    this->y = SvNV(*av_fetch(point_av, 1, 0));
+}
+
+void
+Pointf::from_SV_check(SV* point_sv)
+{
+    if (sv_isobject(point_sv) && (SvTYPE(SvRV(point_sv)) == SVt_PVMG)) {
+        Point* point = (Point*)SvIV((SV*)SvRV( point_sv ));
+        this->x = point->x;
+        this->y = point->y;
+    } else {
+        this->from_SV(point_sv);
+    }
+}
+
+SV*
+Pointf::to_SV_pureperl() const {
+    AV* av = newAV();
+    av_fill(av, 1);
+    av_store(av, 0, newSVnv(this->x));
+    av_store(av, 1, newSVnv(this->y));
+    return newRV_noinc((SV*)av);
+}
 #endif
 
 }
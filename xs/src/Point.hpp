@@ -3,21 +3,47 @@
 
 #include <myinit.h>
 #include <vector>
+#include <limits>
 #include <math.h>
 
 namespace Slic3r {
 
 class Line;
 class Point;
+class Pointf;
 typedef std::vector<Point> Points;
 typedef std::vector<Point*> PointPtrs;
+typedef std::vector<Pointf> Pointfs;
+
+/* Scaled coordinates are stored as coord_t. Building with
+   SLIC3R_32BIT_COORDS halves the size of every point (and of all the
+   polygon buffers) but limits coordinates to COORD_MAX, that is about one
+   metre around the origin; products of coordinate differences must then
+   be computed in a wider type than coord_t. */
+#ifdef SLIC3R_32BIT_COORDS
+typedef int coord_t;
+#else
+typedef long coord_t;
+#endif
+
+/* largest magnitude that keeps the difference of two coordinates in range */
+#define COORD_MAX (std::numeric_limits<coord_t>::max() / 2)
+
+/* Cross products of 64-bit coordinates don't fit a long (nor a double's
+   mantissa), so exact orientation tests accumulate them in 128-bit integers
+   where the compiler provides them. */
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 coord2_t;
+#else
+typedef double coord2_t;
+#endif
 
 class Point
 {
     public:
-    long x;
-    long y;
-    explicit Point(long _x = 0, long _y = 0): x(_x), y(_y) {};
+    coord_t x;
+    coord_t y;
+    explicit Point(coord_t _x = 0, coord_t _y = 0): x(_x), y(_y) {};
     void scale(double factor);
     void translate(double x, double y);
     void rotate(double angle, Point* center);
@@ -42,6 +68,37 @@ class Point
     #endif
 };
 
+/* point with non-integer coordinates, for the Perl helpers that are fed
+   unscaled or computed values and must not round them */
+class Pointf
+{
+    public:
+    double x;
+    double y;
+    explicit Pointf(double _x = 0, double _y = 0): x(_x), y(_y) {};
+    
+    #ifdef SLIC3RXS
+    void from_SV(SV* point_sv);
+    void from_SV_check(SV* point_sv);
+    SV* to_SV_pureperl() const;
+    #endif
+};
+
+#ifdef SLIC3RXS
+/* flat arrayref of coordinates (x0, y0, x1, y1, ...): a single AV instead of
+   one blessed object per point, for callers that only need the numbers */
+SV* points_to_SV_flat(const Points &points);
+
+/* pushes the coordinates of a point on the Perl stack as a (x, y) list;
+   only usable in a PPCODE section */
+#define PUSH_POINT_XY(p) STMT_START { \
+    const Slic3r::Point point_xy = (p); \
+    EXTEND(SP, 2); \
+    PUSHs(sv_2mortal(newSViv(point_xy.x))); \
+    PUSHs(sv_2mortal(newSViv(point_xy.y))); \
+} STMT_END
+#endif
+
 }
 
 #endif
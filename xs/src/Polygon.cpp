@@ -5,16 +5,17 @@
 
 namespace Slic3r {
 
-Point*
+Point
 Polygon::last_point() const
 {
-    return new Point(this->points.front());  // last point == first point for polygons
+    return this->points.front();  // last point == first point for polygons
 }
 
 Lines
 Polygon::lines() const
 {
     Lines lines;
+    if (this->points.empty()) return lines;
     lines.reserve(this->points.size());
     for (Points::const_iterator it = this->points.begin(); it != this->points.end()-1; ++it) {
         lines.push_back(Line(*it, *(it + 1)));
@@ -62,20 +63,35 @@ Polygon::equally_spaced_points(double distance) const
     return pts;
 }
 
+/* Twice the signed area (positive for counter-clockwise polygons), summed over
+   the triangle fan rooted at the first point. The sum is exact where coord2_t
+   is a 128-bit integer, which is what orientation tests need. */
+static coord2_t
+signed_area2(const Points &points)
+{
+    coord2_t a = 0;
+    if (points.size() < 3) return a;
+    const Point &origin = points.front();
+    coord2_t x1 = points[1].x - origin.x, y1 = points[1].y - origin.y;
+    for (Points::const_iterator it = points.begin() + 2; it != points.end(); ++it) {
+        coord2_t x2 = it->x - origin.x, y2 = it->y - origin.y;
+        a += x1 * y2 - x2 * y1;
+        x1 = x2;
+        y1 = y2;
+    }
+    return a;
+}
+
 double
 Polygon::area() const
 {
-    ClipperLib::Path p;
-    Slic3rMultiPoint_to_ClipperPath(*this, p);
-    return ClipperLib::Area(p);
+    return (double)signed_area2(this->points) * 0.5;
 }
 
 bool
 Polygon::is_counter_clockwise() const
 {
-    ClipperLib::Path p;
-    Slic3rMultiPoint_to_ClipperPath(*this, p);
-    return ClipperLib::Orientation(p);
+    return signed_area2(this->points) >= 0;
 }
 
 bool
@@ -119,7 +135,7 @@ Polygon::contains_point(const Point* point) const
     Points::const_iterator j = this->points.end() - 1;
     for (; i != this->points.end(); j = i++) {
         if ( ((i->y > point->y) != (j->y > point->y))
-            && (point->x < (j->x - i->x) * (point->y - i->y) / (j->y - i->y) + i->x) )
+            && (point->x < (long long)(j->x - i->x) * (point->y - i->y) / (j->y - i->y) + i->x) )
             result = !result;
     }
     return result;
@@ -14,7 +14,7 @@ typedef std::vector<Polygon> Polygons;
 
 class Polygon : public MultiPoint {
     public:
-    Point* last_point() const;
+    Point last_point() const;
     Lines lines() const;
     Polyline* split_at(const Point* point) const;
     Polyline* split_at_index(int index) const;
@@ -0,0 +1,240 @@
+#include "PolygonSet.hpp"
+#include <algorithm>
+
+namespace Slic3r {
+
+PolygonSet::PolygonSet()
+    : rings(1, 0), groups(1, 0)
+{}
+
+PolygonSet::PolygonSet(const Polygons &polygons)
+    : rings(1, 0), groups(1, 0)
+{
+    this->append(polygons);
+}
+
+PolygonSet::PolygonSet(const ExPolygons &expolygons)
+    : rings(1, 0), groups(1, 0)
+{
+    this->append(expolygons);
+}
+
+void
+PolygonSet::clear()
+{
+    this->x.clear();
+    this->y.clear();
+    this->rings.assign(1, 0);
+    this->groups.assign(1, 0);
+}
+
+void
+PolygonSet::reserve(size_t points, size_t rings)
+{
+    this->x.reserve(points);
+    this->y.reserve(points);
+    this->rings.reserve(rings + 1);
+}
+
+void
+PolygonSet::append_ring(const Points &points)
+{
+    for (Points::const_iterator it = points.begin(); it != points.end(); ++it) {
+        this->x.push_back(it->x);
+        this->y.push_back(it->y);
+    }
+    this->rings.push_back(this->x.size());
+}
+
+void
+PolygonSet::append(const Points &points)
+{
+    this->append_ring(points);
+    this->groups.push_back(this->size());
+}
+
+void
+PolygonSet::append(const Polygons &polygons)
+{
+    size_t count = 0;
+    for (Polygons::const_iterator it = polygons.begin(); it != polygons.end(); ++it)
+        count += it->points.size();
+    this->reserve(this->points_count() + count, this->size() + polygons.size());
+    for (Polygons::const_iterator it = polygons.begin(); it != polygons.end(); ++it)
+        this->append(it->points);
+}
+
+void
+PolygonSet::append(const ExPolygon &expolygon)
+{
+    this->append_ring(expolygon.contour.points);
+    for (Polygons::const_iterator it = expolygon.holes.begin(); it != expolygon.holes.end(); ++it)
+        this->append_ring(it->points);
+    this->groups.push_back(this->size());
+}
+
+void
+PolygonSet::append(const ExPolygons &expolygons)
+{
+    for (ExPolygons::const_iterator it = expolygons.begin(); it != expolygons.end(); ++it)
+        this->append(*it);
+}
+
+void
+PolygonSet::push_back(const Point &point)
+{
+    this->x.push_back(point.x);
+    this->y.push_back(point.y);
+}
+
+void
+PolygonSet::close_ring()
+{
+    this->rings.push_back(this->x.size());
+    this->groups.push_back(this->size());
+}
+
+/* replaces the content of points with the given ring */
+void
+PolygonSet::copy_ring(size_t ring, Points &points) const
+{
+    const size_t first = this->rings[ring];
+    points.resize(this->ring_size(ring));
+    for (Points::iterator it = points.begin(); it != points.end(); ++it) {
+        const size_t i = first + (it - points.begin());
+        it->x = this->x[i];
+        it->y = this->y[i];
+    }
+}
+
+Polygon
+PolygonSet::polygon(size_t ring) const
+{
+    Polygon p;
+    this->copy_ring(ring, p.points);
+    return p;
+}
+
+void
+PolygonSet::polygons(Polygons &retval) const
+{
+    retval.reserve(retval.size() + this->size());
+    for (size_t ring = 0; ring < this->size(); ++ring)
+        retval.push_back(this->polygon(ring));
+}
+
+/* each group becomes an expolygon having its first ring as contour */
+void
+PolygonSet::expolygons(ExPolygons &retval) const
+{
+    retval.reserve(retval.size() + this->groups.size() - 1);
+    for (size_t g = 0; g + 1 < this->groups.size(); ++g) {
+        retval.push_back(ExPolygon());
+        ExPolygon &expolygon = retval.back();
+        this->copy_ring(this->groups[g], expolygon.contour.points);
+        expolygon.holes.resize(this->groups[g+1] - this->groups[g] - 1);
+        for (size_t ring = this->groups[g] + 1; ring < this->groups[g+1]; ++ring)
+            this->copy_ring(ring, expolygon.holes[ring - this->groups[g] - 1].points);
+    }
+}
+
+/* The transforms below round exactly like their Point counterparts, so that
+   applying them to a set or to each polygon gives the same coordinates. */
+
+void
+PolygonSet::translate(double x, double y)
+{
+    coord_t* px = this->x.empty() ? NULL : &this->x.front();
+    coord_t* py = this->y.empty() ? NULL : &this->y.front();
+    const size_t n = this->x.size();
+    for (size_t i = 0; i < n; ++i) {
+        px[i] = (coord_t)(px[i] + x);
+        py[i] = (coord_t)(py[i] + y);
+    }
+}
+
+void
+PolygonSet::rotate(double angle, const Point &center)
+{
+    const double c = cos(angle), s = sin(angle);
+    const double cx = (double)center.x, cy = (double)center.y;
+    coord_t* px = this->x.empty() ? NULL : &this->x.front();
+    coord_t* py = this->y.empty() ? NULL : &this->y.front();
+    const size_t n = this->x.size();
+    for (size_t i = 0; i < n; ++i) {
+        const double dx = (double)px[i] - cx, dy = (double)py[i] - cy;
+        px[i] = (coord_t)round(cx + c * dx - s * dy);
+        py[i] = (coord_t)round(cy + c * dy + s * dx);
+    }
+}
+
+void
+PolygonSet::scale(double factor)
+{
+    coord_t* px = this->x.empty() ? NULL : &this->x.front();
+    coord_t* py = this->y.empty() ? NULL : &this->y.front();
+    const size_t n = this->x.size();
+    for (size_t i = 0; i < n; ++i) {
+        px[i] = (coord_t)(px[i] * factor);
+        py[i] = (coord_t)(py[i] * factor);
+    }
+}
+
+/* left undefined for an empty set */
+BoundingBox
+PolygonSet::bounding_box() const
+{
+    BoundingBox bb;
+    if (this->x.empty()) return bb;
+    Point &min = bb.min, &max = bb.max;
+    min.x = max.x = this->x.front();
+    min.y = max.y = this->y.front();
+    const size_t n = this->x.size();
+    for (size_t i = 1; i < n; ++i) {
+        min.x = std::min(min.x, this->x[i]);
+        max.x = std::max(max.x, this->x[i]);
+        min.y = std::min(min.y, this->y[i]);
+        max.y = std::max(max.y, this->y[i]);
+    }
+    bb.defined = true;
+    return bb;
+}
+
+/* signed area of each ring, computed exactly like Polygon::area() */
+void
+PolygonSet::areas(std::vector<double> &retval) const
+{
+    retval.reserve(retval.size() + this->size());
+    for (size_t ring = 0; ring < this->size(); ++ring) {
+        const size_t first = this->rings[ring], last = this->rings[ring+1];
+        coord2_t a = 0;
+        if (last - first >= 3) {
+            const coord_t ox = this->x[first], oy = this->y[first];
+            coord2_t x1 = this->x[first+1] - ox, y1 = this->y[first+1] - oy;
+            for (size_t i = first + 2; i < last; ++i) {
+                const coord2_t x2 = this->x[i] - ox, y2 = this->y[i] - oy;
+                a += x1 * y2 - x2 * y1;
+                x1 = x2;
+                y1 = y2;
+            }
+        }
+        retval.push_back((double)a * 0.5);
+    }
+}
+
+/* area of each group, summed over its rings exactly like ExPolygon::area() */
+void
+PolygonSet::group_areas(std::vector<double> &retval) const
+{
+    std::vector<double> ring_areas;
+    this->areas(ring_areas);
+    retval.reserve(retval.size() + this->groups.size() - 1);
+    for (size_t g = 0; g + 1 < this->groups.size(); ++g) {
+        double a = 0;
+        for (size_t ring = this->groups[g]; ring < this->groups[g+1]; ++ring)
+            a += ring_areas[ring];
+        retval.push_back(a);
+    }
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef slic3r_PolygonSet_hpp_
+#define slic3r_PolygonSet_hpp_
+
+#include <myinit.h>
+#include <vector>
+#include "BoundingBox.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+#include "ExPolygon.hpp"
+
+namespace Slic3r {
+
+/* Structure-of-arrays storage for a whole set of polygons: the coordinates of
+   all the rings live in two contiguous arrays, so that layer-wide transforms
+   are plain loops the compiler can vectorize instead of one pointer chase per
+   polygon. Rings are grouped like expolygons (contour first, then holes);
+   each plain polygon is a group of its own. */
+class PolygonSet
+{
+    public:
+    std::vector<coord_t> x;
+    std::vector<coord_t> y;
+    std::vector<size_t> rings;   // first point of each ring, plus the total point count
+    std::vector<size_t> groups;  // first ring of each group, plus the total ring count
+    PolygonSet();
+    explicit PolygonSet(const Polygons &polygons);
+    explicit PolygonSet(const ExPolygons &expolygons);
+    size_t size() const { return this->rings.size() - 1; };
+    size_t points_count() const { return this->x.size(); };
+    size_t ring_size(size_t ring) const { return this->rings[ring+1] - this->rings[ring]; };
+    void clear();
+    void reserve(size_t points, size_t rings);
+    void append(const Points &points);
+    void append(const Polygons &polygons);
+    void append(const ExPolygon &expolygon);
+    void append(const ExPolygons &expolygons);
+    void push_back(const Point &point);  // to the ring being built
+    void close_ring();                   // ends it as a group of its own
+    Polygon polygon(size_t ring) const;
+    void polygons(Polygons &retval) const;
+    void expolygons(ExPolygons &retval) const;
+    void translate(double x, double y);
+    void rotate(double angle, const Point &center);
+    void scale(double factor);
+    BoundingBox bounding_box() const;
+    void areas(std::vector<double> &retval) const;
+    void group_areas(std::vector<double> &retval) const;
+    void copy_ring(size_t ring, Points &points) const;
+
+    private:
+    void append_ring(const Points &points);
+};
+
+}
+
+#endif
@@ -10,16 +10,17 @@ Polyline::operator Polylines() const
     return polylines;
 }
 
-Point*
+Point
 Polyline::last_point() const
 {
-    return new Point(this->points.back());
+    return this->points.back();
 }
 
 Lines
 Polyline::lines() const
 {
     Lines lines;
+    if (this->points.size() < 2) return lines;
     lines.reserve(this->points.size() - 1);
     for (Points::const_iterator it = this->points.begin(); it != this->points.end()-1; ++it) {
         lines.push_back(Line(*it, *(it + 1)));
@@ -32,18 +33,18 @@ void
 Polyline::clip_end(double distance)
 {
     while (distance > 0) {
-        Point last_point = *this->last_point();
+        Point last_point = this->last_point();
         this->points.pop_back();
         if (this->points.empty()) break;
         
-        double last_segment_length = last_point.distance_to(this->last_point());
+        double last_segment_length = last_point.distance_to(&this->points.back());
         if (last_segment_length <= distance) {
             distance -= last_segment_length;
             continue;
         }
         
-        Line segment(last_point, *this->last_point());
-        this->points.push_back(*segment.point_at(distance));
+        Line segment(last_point, this->last_point());
+        this->points.push_back(segment.point_at(distance));
         distance = 0;
     }
 }
@@ -63,7 +64,7 @@ Points
 Polyline::equally_spaced_points(double distance) const
 {
     Points pts;
-    pts.push_back(*this->first_point());
+    pts.push_back(this->first_point());
     double len = 0;
     
     for (Points::const_iterator it = this->points.begin() + 1; it != this->points.end(); ++it) {
@@ -79,7 +80,7 @@ Polyline::equally_spaced_points(double distance) const
         
         double take = segment_length - (len - distance);  // how much we take of this segment
         Line segment(*(it-1), *it);
-        pts.push_back(*segment.point_at(take));
+        pts.push_back(segment.point_at(take));
         it--;
         len = -take;
     }
@@ -1,46 +1,69 @@
 #include "PolylineCollection.hpp"
+#include "Geometry.hpp"
 
 namespace Slic3r {
 
 PolylineCollection*
-PolylineCollection::chained_path(bool no_reverse) const
+PolylineCollection::chained_path(bool no_reverse, bool refine) const
 {
     if (this->polylines.empty()) return new PolylineCollection ();
-    return this->chained_path_from(this->polylines.front().first_point(), no_reverse);
+    Point start_near = this->polylines.front().first_point();
+    return this->chained_path_from(&start_near, no_reverse, refine);
 }
 
 PolylineCollection*
-PolylineCollection::chained_path_from(const Point* start_near, bool no_reverse) const
+PolylineCollection::chained_path_from(const Point* start_near, bool no_reverse, bool refine) const
 {
     PolylineCollection* retval = new PolylineCollection;
-    Polylines my_paths = this->polylines;
+    retval->polylines.reserve(this->polylines.size());
     
     Points endpoints;
-    for (Polylines::const_iterator it = my_paths.begin(); it != my_paths.end(); ++it) {
-        endpoints.push_back(*(*it).first_point());
-        if (no_reverse) {
-            endpoints.push_back(*(*it).first_point());
-        } else {
-            endpoints.push_back(*(*it).last_point());
-        }
+    this->endpoints(endpoints, no_reverse);
+    NearestPointIndex index(endpoints);
+    
+    // the real endpoints, for walking and refining the path
+    Points ends;
+    if (no_reverse) {
+        this->endpoints(ends, false);
+    } else {
+        ends = endpoints;
     }
     
-    while (!my_paths.empty()) {
+    // path holds the endpoint each item is entered from, in travel order
+    std::vector<size_t> path;
+    path.reserve(ends.size() / 2);
+    Point last_point = *start_near;
+    while (index.size() > 0) {
         // find nearest point
-        int start_index = start_near->nearest_point_index(endpoints);
-        int path_index = start_index/2;
-        if (start_index % 2 && !no_reverse) {
-            my_paths.at(path_index).reverse();
-        }
-        retval->polylines.push_back(my_paths.at(path_index));
-        my_paths.erase(my_paths.begin() + path_index);
-        endpoints.erase(endpoints.begin() + 2*path_index, endpoints.begin() + 2*path_index + 2);
-        start_near = retval->polylines.back().last_point();
+        long start_index = index.nearest(last_point);
+        size_t path_index = start_index/2;
+        path.push_back(no_reverse ? 2*path_index : start_index);
+        index.remove(2*path_index);
+        index.remove(2*path_index + 1);
+        last_point = ends[ path.back() ^ 1 ];
+    }
+    if (refine) Geometry::refine_chained_path(*start_near, ends, path, no_reverse);
+    
+    for (std::vector<size_t>::const_iterator it = path.begin(); it != path.end(); ++it) {
+        retval->polylines.push_back(this->polylines[*it / 2]);
+        if (*it % 2) retval->polylines.back().reverse();
     }
     
     return retval;
 }
 
+/* appends the first and last point of each polyline to retval, in order;
+   when no_reverse is true the first point is repeated instead of the last one */
+void
+PolylineCollection::endpoints(Points &retval, bool no_reverse) const
+{
+    retval.reserve(retval.size() + 2 * this->polylines.size());
+    for (Polylines::const_iterator it = this->polylines.begin(); it != this->polylines.end(); ++it) {
+        retval.push_back(it->points.front());
+        retval.push_back(no_reverse ? it->points.front() : it->points.back());
+    }
+}
+
 Point*
 PolylineCollection::leftmost_point() const
 {
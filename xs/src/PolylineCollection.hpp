@@ -10,9 +10,10 @@ class PolylineCollection
 {
     public:
     Polylines polylines;
-    PolylineCollection* chained_path(bool no_reverse) const;
-    PolylineCollection* chained_path_from(const Point* start_near, bool no_reverse) const;
+    PolylineCollection* chained_path(bool no_reverse, bool refine = false) const;
+    PolylineCollection* chained_path_from(const Point* start_near, bool no_reverse, bool refine = false) const;
     Point* leftmost_point() const;
+    void endpoints(Points &retval, bool no_reverse = false) const;
 };
 
 }
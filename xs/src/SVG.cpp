@@ -17,7 +17,7 @@ SVG::SVG(const char* filename)
 }
 
 float
-SVG::coordinate(long c)
+SVG::coordinate(coord_t c)
 {
     return (float)unscale(c)*10;
 }
@@ -11,7 +11,7 @@ class SVG
 {
     private:
     FILE* f;
-    float coordinate(long c);
+    float coordinate(coord_t c);
     public:
     bool arrows;
     SVG(const char* filename);
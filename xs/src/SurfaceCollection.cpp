@@ -1,15 +1,28 @@
 #include "SurfaceCollection.hpp"
+#include "ClipperUtils.hpp"
+#include "Geometry.hpp"
+#include "PolygonSet.hpp"
 #include <map>
 
 namespace Slic3r {
 
 void
-SurfaceCollection::simplify(double tolerance)
+SurfaceCollection::simplify(double tolerance, unsigned int threads_count)
 {
+    // same as ExPolygon::simplify() on each surface, but all the rings of the
+    // collection go through Douglas-Peucker in a single batch
+    ExPolygons simplified;
+    simplified.reserve(this->surfaces.size());
+    for (Surfaces::const_iterator it_s = this->surfaces.begin(); it_s != this->surfaces.end(); ++it_s)
+        simplified.push_back(it_s->expolygon);
+    Geometry::douglas_peucker(simplified, tolerance, threads_count);
+    
     Surfaces ss;
     for (Surfaces::const_iterator it_s = this->surfaces.begin(); it_s != this->surfaces.end(); ++it_s) {
+        Polygons pp = simplified[it_s - this->surfaces.begin()];
+        simplify_polygons(pp, pp);
         ExPolygons expp;
-        it_s->expolygon.simplify(tolerance, expp);
+        union_(pp, expp);
         for (ExPolygons::const_iterator it_e = expp.begin(); it_e != expp.end(); ++it_e) {
             Surface s = *it_s;
             s.expolygon = *it_e;
@@ -19,6 +32,26 @@ SurfaceCollection::simplify(double tolerance)
     this->surfaces = ss;
 }
 
+BoundingBox
+SurfaceCollection::bounding_box() const
+{
+    BoundingBox bb;
+    for (Surfaces::const_iterator it = this->surfaces.begin(); it != this->surfaces.end(); ++it)
+        bb.merge(it->expolygon.contour.points);
+    return bb;
+}
+
+/* area of each surface, in order: the rings of all the surfaces are gathered
+   into a single PolygonSet so that the shoelace sums run over flat arrays */
+void
+SurfaceCollection::areas(std::vector<double> &retval) const
+{
+    PolygonSet set;
+    for (Surfaces::const_iterator it = this->surfaces.begin(); it != this->surfaces.end(); ++it)
+        set.append(it->expolygon);
+    set.group_areas(retval);
+}
+
 /* group surfaces by common properties */
 void
 SurfaceCollection::group(std::vector<SurfacesPtr> *retval, bool merge_solid)
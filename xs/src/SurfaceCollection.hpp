@@ -10,7 +10,9 @@ class SurfaceCollection
 {
     public:
     Surfaces surfaces;
-    void simplify(double tolerance);
+    void simplify(double tolerance, unsigned int threads_count = 0);
+    BoundingBox bounding_box() const;
+    void areas(std::vector<double> &retval) const;
     void group(std::vector<SurfacesPtr> *retval, bool merge_solid = false);
 };
 
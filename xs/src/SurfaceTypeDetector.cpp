@@ -0,0 +1,138 @@
+#include "SurfaceTypeDetector.hpp"
+#include "ClipperUtils.hpp"
+
+namespace Slic3r {
+
+static void
+append_polygons(const ExPolygons &expolygons, Polygons &retval)
+{
+    for (ExPolygons::const_iterator ex = expolygons.begin(); ex != expolygons.end(); ++ex) {
+        Polygons pp = *ex;
+        retval.insert(retval.end(), pp.begin(), pp.end());
+    }
+}
+
+static void
+append_polygons(const Surfaces &surfaces, Polygons &retval)
+{
+    for (Surfaces::const_iterator surface = surfaces.begin(); surface != surfaces.end(); ++surface) {
+        Polygons pp = surface->expolygon;
+        retval.insert(retval.end(), pp.begin(), pp.end());
+    }
+}
+
+static void
+append_surfaces(const ExPolygons &expolygons, SurfaceType surface_type, Surfaces &retval)
+{
+    for (ExPolygons::const_iterator ex = expolygons.begin(); ex != expolygons.end(); ++ex) {
+        Surface s;
+        s.expolygon         = *ex;
+        s.surface_type      = surface_type;
+        s.thickness         = -1;
+        s.thickness_layers  = 1;
+        s.bridge_angle      = -1;
+        s.extra_perimeters  = 0;
+        retval.push_back(s);
+    }
+}
+
+/* surfaces of the given type covering subject but not clip, with very narrow
+   parts collapsed (using the safety offset in the diff is not enough) */
+static void
+difference(const Polygons &subject, const Polygons &clip, double offset,
+    SurfaceType surface_type, Surfaces &retval)
+{
+    Polygons diff_pp;
+    diff(subject, clip, diff_pp, false);
+    ExPolygons diff_ex;
+    offset2_ex(diff_pp, diff_ex, -offset, +offset);
+    append_surfaces(diff_ex, surface_type, retval);
+}
+
+void
+SurfaceTypeDetector::add_layer(SurfaceCollection* slices, const ExPolygonCollection* layer_slices,
+    double offset, SurfaceCollection* fill_surfaces)
+{
+    Layer layer;
+    layer.slices        = slices;
+    layer.layer_slices  = layer_slices;
+    layer.offset        = offset;
+    layer.fill_surfaces = fill_surfaces;
+    this->layers.push_back(layer);
+}
+
+void
+SurfaceTypeDetector::detect(unsigned int threads_count)
+{
+    parallelize(*this, this->layers.size(), threads_count);
+}
+
+void
+SurfaceTypeDetector::run(size_t idx)
+{
+    const Layer &layer = this->layers[idx];
+    Surfaces &slices = layer.slices->surfaces;
+    Polygons slices_pp;
+    append_polygons(slices, slices_pp);
+    
+    // find top surfaces (difference between current surfaces
+    // of current layer and upper one)
+    Surfaces top;
+    if (idx + 1 < this->layers.size()) {
+        difference(slices_pp, *this->layers[idx+1].layer_slices, layer.offset, stTop, top);
+    } else {
+        // if no upper layer, all surfaces of this one are solid
+        top = slices;
+        for (Surfaces::iterator s = top.begin(); s != top.end(); ++s) s->surface_type = stTop;
+    }
+    
+    // find bottom surfaces (difference between current surfaces
+    // of current layer and lower one)
+    Surfaces bottom;
+    if (idx > 0) {
+        difference(slices_pp, *this->layers[idx-1].layer_slices, layer.offset, stBottom, bottom);
+    } else {
+        // if no lower layer, all surfaces of this one are solid
+        bottom = slices;
+        for (Surfaces::iterator s = bottom.begin(); s != bottom.end(); ++s) s->surface_type = stBottom;
+    }
+    
+    // now, if the object contained a thin membrane, we could have overlapping bottom
+    // and top surfaces; let's do an intersection to discover them and consider them
+    // as bottom surfaces (to allow for bridge detection)
+    if (!top.empty() && !bottom.empty()) {
+        Polygons top_pp, bottom_pp;
+        append_polygons(top, top_pp);
+        append_polygons(bottom, bottom_pp);
+        ExPolygons overlapping;
+        intersection(top_pp, bottom_pp, overlapping, false);
+        Polygons overlapping_pp;
+        append_polygons(overlapping, overlapping_pp);
+        top.clear();
+        difference(top_pp, overlapping_pp, layer.offset, stTop, top);
+    }
+    
+    // find internal surfaces (difference between top/bottom surfaces and others)
+    Polygons solid_pp;
+    append_polygons(top, solid_pp);
+    append_polygons(bottom, solid_pp);
+    Surfaces internal;
+    difference(slices_pp, solid_pp, layer.offset, stInternal, internal);
+    
+    slices.clear();
+    slices.insert(slices.end(), bottom.begin(), bottom.end());
+    slices.insert(slices.end(), top.begin(), top.end());
+    slices.insert(slices.end(), internal.begin(), internal.end());
+    
+    // clip surfaces to the fill boundaries
+    Polygons fill_boundaries;
+    append_polygons(layer.fill_surfaces->surfaces, fill_boundaries);
+    layer.fill_surfaces->surfaces.clear();
+    for (Surfaces::const_iterator surface = slices.begin(); surface != slices.end(); ++surface) {
+        ExPolygons clipped;
+        intersection((Polygons)surface->expolygon, fill_boundaries, clipped, false);
+        append_surfaces(clipped, surface->surface_type, layer.fill_surfaces->surfaces);
+    }
+}
+
+}
@@ -0,0 +1,41 @@
+#ifndef slic3r_SurfaceTypeDetector_hpp_
+#define slic3r_SurfaceTypeDetector_hpp_
+
+#include <myinit.h>
+#include "ExPolygonCollection.hpp"
+#include "Parallel.hpp"
+#include "SurfaceCollection.hpp"
+#include <vector>
+
+namespace Slic3r {
+
+/* Classifies the slices of a region, layer by layer from the bottom, as top,
+   bottom or internal surfaces by comparing them with the full slices (all
+   regions merged) of the layers above and below; areas being both top and
+   bottom (thin membranes) are kept as bottom to allow for bridge detection.
+   The fill surfaces of each layer are then clipped to its classified slices.
+   Each layer only reads the full slices of its neighbors, so all of them are
+   processed concurrently, on up to threads_count threads (0 means one per
+   core); the collections are borrowed, not owned. */
+class SurfaceTypeDetector : public ParallelJob
+{
+    public:
+    void add_layer(SurfaceCollection* slices, const ExPolygonCollection* layer_slices,
+        double offset, SurfaceCollection* fill_surfaces);
+    void detect(unsigned int threads_count = 0);
+    void run(size_t idx);
+    
+    private:
+    struct Layer
+    {
+        SurfaceCollection* slices;              // of the region, classified in place
+        const ExPolygonCollection* layer_slices;  // of all regions
+        double offset;                          // to collapse very narrow parts
+        SurfaceCollection* fill_surfaces;       // clipped in place
+    };
+    std::vector<Layer> layers;
+};
+
+}
+
+#endif
@@ -17,6 +17,15 @@
 
 namespace Slic3r {
 
+/* the XY extents of the mesh, once scaled, must fit a coord_t */
+static void
+check_coordinate_range(const stl_stats &stats)
+{
+    const double limit = unscale((double)COORD_MAX);
+    if (stats.min.x < -limit || stats.min.y < -limit || stats.max.x > limit || stats.max.y > limit)
+        CONFESS("The mesh exceeds the supported coordinate range (+/-%.0f mm)", limit);
+}
+
 TriangleMesh::TriangleMesh()
     : repaired(false)
 {
@@ -165,6 +174,17 @@ void TriangleMesh::rotate(double angle, Point* center)
 
 void
 TriangleMesh::slice(const std::vector<double> &z, std::vector<Polygons> &layers)
+{
+    std::vector<PolygonSet> sets;
+    this->slice(z, sets);
+    layers.resize(sets.size());
+    for (std::vector<PolygonSet>::const_iterator it = sets.begin(); it != sets.end(); ++it)
+        it->polygons(layers[it - sets.begin()]);
+}
+
+/* each layer's loops are appended to a single PolygonSet as they are closed */
+void
+TriangleMesh::slice(const std::vector<double> &z, std::vector<PolygonSet> &layers)
 {
     /*
        This method gets called with a list of unscaled Z coordinates and outputs
@@ -192,6 +212,7 @@ TriangleMesh::slice(const std::vector<double> &z, std::vector<Polygons> &layers)
     */
     
     if (!this->repaired) this->repair();
+    check_coordinate_range(this->stl.stats);
     
     // build a table to map a facet_idx to its three edge indices
     if (this->stl.v_shared == NULL) stl_generate_shared_vertices(&(this->stl));
@@ -475,15 +496,14 @@ TriangleMesh::slice(const std::vector<double> &z, std::vector<Polygons> &layers)
                     if ((loop.front()->edge_a_id != -1 && loop.front()->edge_a_id == loop.back()->edge_b_id)
                         || (loop.front()->a_id != -1 && loop.front()->a_id == loop.back()->b_id)) {
                         // loop is complete
-                        Polygon p;
-                        p.points.reserve(loop.size());
+                        PolygonSet &layer = layers[layer_idx];
                         for (IntersectionLinePtrs::iterator lineptr = loop.begin(); lineptr != loop.end(); ++lineptr) {
-                            p.points.push_back((*lineptr)->a);
+                            layer.push_back((*lineptr)->a);
                         }
-                        layers[layer_idx].push_back(p);
+                        layer.close_ring();
                         
                         #ifdef SLIC3R_DEBUG
-                        printf("  Discovered %s polygon of %d points\n", (p.is_counter_clockwise() ? "ccw" : "cw"), (int)p.points.size());
+                        printf("  Discovered %s polygon of %d points\n", (layer.polygon(layer.size()-1).is_counter_clockwise() ? "ccw" : "cw"), (int)loop.size());
                         #endif
                         
                         goto CYCLE;
@@ -586,6 +606,7 @@ TriangleMesh::merge(const TriangleMesh* mesh)
 void
 TriangleMesh::horizontal_projection(ExPolygons &retval) const
 {
+    check_coordinate_range(this->stl.stats);
     Polygons pp;
     pp.reserve(this->stl.stats.number_of_facets);
     for (int i = 0; i < this->stl.stats.number_of_facets; i++) {
@@ -600,13 +621,15 @@ TriangleMesh::horizontal_projection(ExPolygons &retval) const
     }
     
     // the offset factor was tuned using groovemount.stl
-    offset(pp, pp, 0.01 / SCALING_FACTOR);
-    union_(pp, retval, true);
+    ExPolygons grown;
+    offset_ex(pp, grown, 0.01 / SCALING_FACTOR);
+    union_parallel(grown, retval, true);
 }
 
 void
 TriangleMesh::convex_hull(Polygon* hull)
 {
+    check_coordinate_range(this->stl.stats);
     if (this->stl.v_shared == NULL) stl_generate_shared_vertices(&(this->stl));
     Points pp;
     pp.reserve(this->stl.stats.shared_vertices);
@@ -617,6 +640,16 @@ TriangleMesh::convex_hull(Polygon* hull)
     Slic3r::Geometry::convex_hull(pp, hull);
 }
 
+/* unscaled, like the mesh itself; relies on the stats being up to date */
+BoundingBox3
+TriangleMesh::bounding_box() const
+{
+    BoundingBox3 bb;
+    bb.merge(this->stl.stats.min.x, this->stl.stats.min.y, this->stl.stats.min.z);
+    bb.merge(this->stl.stats.max.x, this->stl.stats.max.y, this->stl.stats.max.z);
+    return bb;
+}
+
 #ifdef SLIC3RXS
 SV*
 TriangleMesh::to_SV() {
@@ -7,6 +7,7 @@
 #include "Point.hpp"
 #include "Polygon.hpp"
 #include "ExPolygon.hpp"
+#include "PolygonSet.hpp"
 
 namespace Slic3r {
 
@@ -30,10 +31,12 @@ class TriangleMesh
     void align_to_origin();
     void rotate(double angle, Point* center);
     void slice(const std::vector<double> &z, std::vector<Polygons> &layers);
+    void slice(const std::vector<double> &z, std::vector<PolygonSet> &layers);
     TriangleMeshPtrs split() const;
     void merge(const TriangleMesh* mesh);
     void horizontal_projection(ExPolygons &retval) const;
     void convex_hull(Polygon* hull);
+    BoundingBox3 bounding_box() const;
     stl_file stl;
     bool repaired;
     
@@ -719,14 +719,8 @@ void ReversePolyPtLinks(OutPt *pp)
 
 void DisposeOutPts(OutPt*& pp)
 {
-  if (pp == 0) return;
-    pp->Prev->Next = 0;
-  while( pp )
-  {
-    OutPt *tmpPp = pp;
-    pp = pp->Next;
-    delete tmpPp;
-  }
+  //the points themselves belong to the engine's MemoryArena
+  pp = 0;
 }
 //------------------------------------------------------------------------------
 
@@ -1061,6 +1055,71 @@ bool HorzSegmentsOverlap(const IntPoint& pt1a, const IntPoint& pt1b,
 }
 
 
+//------------------------------------------------------------------------------
+// MemoryArena methods ...
+//------------------------------------------------------------------------------
+
+static size_t const ArenaChunkSize = 64 * 1024;
+static size_t const ArenaAlignment = 16;
+
+MemoryArena::~MemoryArena()
+{
+  for (size_t i = 0; i < m_Chunks.size(); ++i)
+    std::free(m_Chunks[i].Data);
+}
+//------------------------------------------------------------------------------
+
+void* MemoryArena::Alloc(size_t size)
+{
+  size = (size + ArenaAlignment - 1) & ~(ArenaAlignment - 1);
+  if (m_Current < m_Chunks.size() && m_Used + size <= m_Chunks[m_Current].Size)
+  {
+    void* result = m_Chunks[m_Current].Data + m_Used;
+    m_Used += size;
+    return result;
+  }
+
+  //move on to the next recycled chunk, or add a new one if it's too small ...
+  if (m_Current < m_Chunks.size()) ++m_Current;
+  if (m_Current == m_Chunks.size() || m_Chunks[m_Current].Size < size)
+  {
+    Chunk chunk;
+    chunk.Size = std::max(size, m_Chunks.empty() ? ArenaChunkSize : 2 * m_Chunks.back().Size);
+    chunk.Data = static_cast<char*>(std::malloc(chunk.Size));
+    if (!chunk.Data) throw std::bad_alloc();
+    m_Chunks.insert(m_Chunks.begin() + m_Current, chunk);
+  }
+  m_Used = size;
+  return m_Chunks[m_Current].Data;
+}
+//------------------------------------------------------------------------------
+
+void MemoryArena::Reset()
+{
+  m_Current = 0;
+  m_Used = 0;
+}
+//------------------------------------------------------------------------------
+
+void MemoryArena::Trim(size_t maxCapacity)
+{
+  Reset();
+  size_t kept = 0, i = 0;
+  for (; i < m_Chunks.size() && kept + m_Chunks[i].Size <= maxCapacity; ++i)
+    kept += m_Chunks[i].Size;
+  for (size_t j = i; j < m_Chunks.size(); ++j)
+    std::free(m_Chunks[j].Data);
+  m_Chunks.resize(i);
+}
+//------------------------------------------------------------------------------
+
+size_t MemoryArena::Capacity() const
+{
+  size_t result = 0;
+  for (size_t i = 0; i < m_Chunks.size(); ++i) result += m_Chunks[i].Size;
+  return result;
+}
+
 //------------------------------------------------------------------------------
 // ClipperBase class methods ...
 //------------------------------------------------------------------------------
@@ -1111,7 +1170,7 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
   if ((Closed && highI < 2) || (!Closed && highI < 1)) return false;
 
   //create a new edge array ...
-  TEdge *edges = new TEdge [highI +1];
+  TEdge *edges = m_EdgeArena.CreateArray<TEdge>(highI +1);
 
   //1. Basic initialization of Edges ...
   try
@@ -1129,7 +1188,6 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
   }
   catch(...)
   {
-    delete [] edges;
     return false; //almost certainly a vertex has exceeded range
   }
 
@@ -1173,10 +1231,7 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
   }
 
   if ((!Closed && (E == E->Next)) || (Closed && (E->Prev == E->Next)))
-  {
-    delete [] edges;
     return false;
-  }
   m_edges.push_back(edges);
 
   if (!Closed)
@@ -1277,7 +1332,7 @@ void ClipperBase::DoMinimaLML(TEdge* E1, TEdge* E2, bool IsClosed)
   if (!E1)
   {
     if (!E2) return;
-    LocalMinima* NewLm = new LocalMinima;
+    LocalMinima* NewLm = m_EdgeArena.Create<LocalMinima>();
     NewLm->Next = 0;
     NewLm->Y = E2->Bot.Y;
     NewLm->LeftBound = 0;
@@ -1287,7 +1342,7 @@ void ClipperBase::DoMinimaLML(TEdge* E1, TEdge* E2, bool IsClosed)
   } else
   {
     //E and E.Prev are now at a local minima ...
-    LocalMinima* NewLm = new LocalMinima;
+    LocalMinima* NewLm = m_EdgeArena.Create<LocalMinima>();
     NewLm->Y = E1->Bot.Y;
     NewLm->Next = 0;
     if (IsHorizontal(*E2)) //Horz. edges never start a Left bound
@@ -1460,14 +1515,9 @@ TEdge* ClipperBase::AddBoundsToLML(TEdge* E, bool IsClosed)
 void ClipperBase::Clear()
 {
   DisposeLocalMinimaList();
-  for (EdgeList::size_type i = 0; i < m_edges.size(); ++i)
-  {
-    //for each edge array in turn, find the first used edge and 
-    //check for and remove any hiddenPts in each edge in the array.
-    TEdge* edges = m_edges[i];
-    delete [] edges;
-  }
+  //edge arrays live in m_EdgeArena ...
   m_edges.clear();
+  m_EdgeArena.Reset();
   m_UseFullRange = false;
   m_HasOpenPaths = false;
 }
@@ -1503,12 +1553,8 @@ void ClipperBase::Reset()
 
 void ClipperBase::DisposeLocalMinimaList()
 {
-  while( m_MinimaList )
-  {
-    LocalMinima* tmpLm = m_MinimaList->Next;
-    delete m_MinimaList;
-    m_MinimaList = tmpLm;
-  }
+  //local minima live in m_EdgeArena ...
+  m_MinimaList = 0;
   m_CurrentLM = 0;
 }
 //------------------------------------------------------------------------------
@@ -1600,10 +1646,25 @@ void Clipper::Clear()
 {
   if (m_edges.empty()) return; //avoids problems with ClipperBase destructor
   DisposeAllOutRecs();
+  m_OutArena.Reset();
   ClipperBase::Clear();
 }
 //------------------------------------------------------------------------------
 
+void Clipper::TrimMemory(size_t maxCapacity)
+{
+  Clear();
+  m_OutArena.Trim(maxCapacity);
+  m_EdgeArena.Trim(maxCapacity);
+}
+//------------------------------------------------------------------------------
+
+size_t Clipper::MemoryCapacity() const
+{
+  return m_EdgeArena.Capacity() + m_OutArena.Capacity();
+}
+//------------------------------------------------------------------------------
+
 void Clipper::Reset()
 {
   ClipperBase::Reset();
@@ -1611,6 +1672,7 @@ void Clipper::Reset()
   m_ActiveEdges = 0;
   m_SortedEdges = 0;
   DisposeAllOutRecs();
+  m_OutArena.Reset(); //nothing from a previous Execute() is referenced anymore
   LocalMinima* lm = m_MinimaList;
   while (lm)
   {
@@ -1749,7 +1811,6 @@ void Clipper::DisposeOutRec(PolyOutList::size_type index)
 {
   OutRec *outRec = m_PolyOuts[index];
   if (outRec->Pts) DisposeOutPts(outRec->Pts);
-  delete outRec;
   m_PolyOuts[index] = 0;
 }
 //------------------------------------------------------------------------------
@@ -2055,7 +2116,7 @@ void Clipper::CopyAELToSEL()
 
 void Clipper::AddJoin(OutPt *op1, OutPt *op2, const IntPoint OffPt)
 {
-  Join* j = new Join;
+  Join* j = m_OutArena.Create<Join>();
   j->OutPt1 = op1;
   j->OutPt2 = op2;
   j->OffPt = OffPt;
@@ -2065,23 +2126,19 @@ void Clipper::AddJoin(OutPt *op1, OutPt *op2, const IntPoint OffPt)
 
 void Clipper::ClearJoins()
 {
-  for (JoinList::size_type i = 0; i < m_Joins.size(); i++)
-    delete m_Joins[i];
   m_Joins.resize(0);
 }
 //------------------------------------------------------------------------------
 
 void Clipper::ClearGhostJoins()
 {
-  for (JoinList::size_type i = 0; i < m_GhostJoins.size(); i++)
-    delete m_GhostJoins[i];
   m_GhostJoins.resize(0);
 }
 //------------------------------------------------------------------------------
 
 void Clipper::AddGhostJoin(OutPt *op, const IntPoint OffPt)
 {
-  Join* j = new Join;
+  Join* j = m_OutArena.Create<Join>();
   j->OutPt1 = op;
   j->OutPt2 = 0;
   j->OffPt = OffPt;
@@ -2596,7 +2653,7 @@ void Clipper::AppendPolygon(TEdge *e1, TEdge *e2)
 
 OutRec* Clipper::CreateOutRec()
 {
-  OutRec* result = new OutRec;
+  OutRec* result = m_OutArena.Create<OutRec>();
   result->IsHole = false;
   result->IsOpen = false;
   result->FirstLeft = 0;
@@ -2616,7 +2673,7 @@ OutPt* Clipper::AddOutPt(TEdge *e, const IntPoint &pt)
   {
     OutRec *outRec = CreateOutRec();
     outRec->IsOpen = (e->WindDelta == 0);
-    OutPt* newOp = new OutPt;
+    OutPt* newOp = m_OutArena.Create<OutPt>();
     outRec->Pts = newOp;
     newOp->Idx = outRec->Idx;
     newOp->Pt = pt;
@@ -2640,7 +2697,7 @@ OutPt* Clipper::AddOutPt(TEdge *e, const IntPoint &pt)
     if (ToFront && (pt == op->Pt)) return op;
     else if (!ToFront && (pt == op->Prev->Pt)) return op->Prev;
 
-    OutPt* newOp = new OutPt;
+    OutPt* newOp = m_OutArena.Create<OutPt>();
     newOp->Idx = outRec->Idx;
     newOp->Pt = pt;
     newOp->Next = op;
@@ -3026,12 +3083,8 @@ bool Clipper::ProcessIntersections(const cInt botY, const cInt topY)
 
 void Clipper::DisposeIntersectNodes()
 {
-  while ( m_IntersectNodes )
-  {
-    IntersectNode* iNode = m_IntersectNodes->Next;
-    delete m_IntersectNodes;
-    m_IntersectNodes = iNode;
-  }
+  //intersect nodes live in m_OutArena ...
+  m_IntersectNodes = 0;
 }
 //------------------------------------------------------------------------------
 
@@ -3088,7 +3141,7 @@ void Clipper::BuildIntersectList(const cInt botY, const cInt topY)
 
 void Clipper::InsertIntersectNode(TEdge *e1, TEdge *e2, const IntPoint &Pt)
 {
-  IntersectNode* newNode = new IntersectNode;
+  IntersectNode* newNode = m_OutArena.Create<IntersectNode>();
   newNode->Edge1 = e1;
   newNode->Edge2 = e2;
   newNode->Pt = Pt;
@@ -3120,7 +3173,6 @@ void Clipper::ProcessIntersectList()
         m_IntersectNodes->Edge2 , m_IntersectNodes->Pt, true);
       SwapPositionsInAEL( m_IntersectNodes->Edge1 , m_IntersectNodes->Edge2 );
     }
-    delete m_IntersectNodes;
     m_IntersectNodes = iNode;
   }
 }
@@ -3295,11 +3347,9 @@ void Clipper::FixupOutPolygon(OutRec &outrec)
       !Pt2IsBetweenPt1AndPt3(pp->Prev->Pt, pp->Pt, pp->Next->Pt))))
     {
       lastOK = 0;
-      OutPt *tmp = pp;
       pp->Prev->Next = pp->Next;
       pp->Next->Prev = pp->Prev;
       pp = pp->Prev;
-      delete tmp;
     }
     else if (pp == lastOK) break;
     else
@@ -3508,9 +3558,9 @@ void Clipper::InsertEdgeIntoAEL(TEdge *edge, TEdge* startEdge)
 }
 //----------------------------------------------------------------------
 
-OutPt* DupOutPt(OutPt* outPt, bool InsertAfter)
+OutPt* DupOutPt(MemoryArena &arena, OutPt* outPt, bool InsertAfter)
 {
-  OutPt* result = new OutPt;
+  OutPt* result = arena.Create<OutPt>();
   result->Pt = outPt->Pt;
   result->Idx = outPt->Idx;
   if (InsertAfter)
@@ -3531,7 +3581,7 @@ OutPt* DupOutPt(OutPt* outPt, bool InsertAfter)
 }
 //------------------------------------------------------------------------------
 
-bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
+bool JoinHorz(MemoryArena &arena, OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
   const IntPoint Pt, bool DiscardLeft)
 {
   Direction Dir1 = (op1->Pt.X > op1b->Pt.X ? dRightToLeft : dLeftToRight);
@@ -3549,12 +3599,12 @@ bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
       op1->Next->Pt.X >= op1->Pt.X && op1->Next->Pt.Y == Pt.Y)  
         op1 = op1->Next;
     if (DiscardLeft && (op1->Pt.X != Pt.X)) op1 = op1->Next;
-    op1b = DupOutPt(op1, !DiscardLeft);
+    op1b = DupOutPt(arena, op1, !DiscardLeft);
     if (op1b->Pt != Pt) 
     {
       op1 = op1b;
       op1->Pt = Pt;
-      op1b = DupOutPt(op1, !DiscardLeft);
+      op1b = DupOutPt(arena, op1, !DiscardLeft);
     }
   } 
   else
@@ -3563,12 +3613,12 @@ bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
       op1->Next->Pt.X <= op1->Pt.X && op1->Next->Pt.Y == Pt.Y) 
         op1 = op1->Next;
     if (!DiscardLeft && (op1->Pt.X != Pt.X)) op1 = op1->Next;
-    op1b = DupOutPt(op1, DiscardLeft);
+    op1b = DupOutPt(arena, op1, DiscardLeft);
     if (op1b->Pt != Pt)
     {
       op1 = op1b;
       op1->Pt = Pt;
-      op1b = DupOutPt(op1, DiscardLeft);
+      op1b = DupOutPt(arena, op1, DiscardLeft);
     }
   }
 
@@ -3578,12 +3628,12 @@ bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
       op2->Next->Pt.X >= op2->Pt.X && op2->Next->Pt.Y == Pt.Y)
         op2 = op2->Next;
     if (DiscardLeft && (op2->Pt.X != Pt.X)) op2 = op2->Next;
-    op2b = DupOutPt(op2, !DiscardLeft);
+    op2b = DupOutPt(arena, op2, !DiscardLeft);
     if (op2b->Pt != Pt)
     {
       op2 = op2b;
       op2->Pt = Pt;
-      op2b = DupOutPt(op2, !DiscardLeft);
+      op2b = DupOutPt(arena, op2, !DiscardLeft);
     };
   } else
   {
@@ -3591,12 +3641,12 @@ bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
       op2->Next->Pt.X <= op2->Pt.X && op2->Next->Pt.Y == Pt.Y) 
         op2 = op2->Next;
     if (!DiscardLeft && (op2->Pt.X != Pt.X)) op2 = op2->Next;
-    op2b = DupOutPt(op2, DiscardLeft);
+    op2b = DupOutPt(arena, op2, DiscardLeft);
     if (op2b->Pt != Pt)
     {
       op2 = op2b;
       op2->Pt = Pt;
-      op2b = DupOutPt(op2, DiscardLeft);
+      op2b = DupOutPt(arena, op2, DiscardLeft);
     };
   };
 
@@ -3649,8 +3699,8 @@ bool Clipper::JoinPoints(const Join *j, OutPt *&p1, OutPt *&p2)
     if (reverse1 == reverse2) return false;
     if (reverse1)
     {
-      op1b = DupOutPt(op1, false);
-      op2b = DupOutPt(op2, true);
+      op1b = DupOutPt(m_OutArena, op1, false);
+      op2b = DupOutPt(m_OutArena, op2, true);
       op1->Prev = op2;
       op2->Next = op1;
       op1b->Next = op2b;
@@ -3660,8 +3710,8 @@ bool Clipper::JoinPoints(const Join *j, OutPt *&p1, OutPt *&p2)
       return true;
     } else
     {
-      op1b = DupOutPt(op1, true);
-      op2b = DupOutPt(op2, false);
+      op1b = DupOutPt(m_OutArena, op1, true);
+      op2b = DupOutPt(m_OutArena, op2, false);
       op1->Next = op2;
       op2->Prev = op1;
       op1b->Prev = op2b;
@@ -3717,7 +3767,7 @@ bool Clipper::JoinPoints(const Join *j, OutPt *&p1, OutPt *&p2)
       Pt = op2b->Pt; DiscardLeftSide = (op2b->Pt.X > op2->Pt.X);
     }
     p1 = op1; p2 = op2;
-    return JoinHorz(op1, op1b, op2, op2b, Pt, DiscardLeftSide);
+    return JoinHorz(m_OutArena, op1, op1b, op2, op2b, Pt, DiscardLeftSide);
   } else
   {
     //nb: For non-horizontal joins ...
@@ -3753,8 +3803,8 @@ bool Clipper::JoinPoints(const Join *j, OutPt *&p1, OutPt *&p2)
 
     if (Reverse1)
     {
-      op1b = DupOutPt(op1, false);
-      op2b = DupOutPt(op2, true);
+      op1b = DupOutPt(m_OutArena, op1, false);
+      op2b = DupOutPt(m_OutArena, op2, true);
       op1->Prev = op2;
       op2->Next = op1;
       op1b->Next = op2b;
@@ -3764,8 +3814,8 @@ bool Clipper::JoinPoints(const Join *j, OutPt *&p1, OutPt *&p2)
       return true;
     } else
     {
-      op1b = DupOutPt(op1, true);
-      op2b = DupOutPt(op2, false);
+      op1b = DupOutPt(m_OutArena, op1, true);
+      op2b = DupOutPt(m_OutArena, op2, false);
       op1->Next = op2;
       op2->Prev = op1;
       op1b->Prev = op2b;
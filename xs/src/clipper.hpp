@@ -58,6 +58,7 @@
 #include <cstdlib>
 #include <ostream>
 #include <functional>
+#include <new>
 
 namespace ClipperLib {
 
@@ -212,6 +213,39 @@ struct OutPt;
 struct OutRec;
 struct Join;
 
+//MemoryArena is a bump allocator for the engine's internal records (edges,
+//local minima, output records and points, joins and intersect nodes). The
+//records are never freed one by one: Reset() makes the whole arena available
+//again while keeping its chunks, so an engine that is Clear()ed and reused
+//stops calling malloc once its arenas have grown to the working set size.
+//Trim() resets it too, and frees the chunks beyond the given capacity so that
+//one huge operation doesn't pin its working set for the engine's lifetime.
+//Only types with trivial destructors may be allocated from it.
+class MemoryArena
+{
+public:
+  MemoryArena(): m_Current(0), m_Used(0) {};
+  ~MemoryArena();
+  void* Alloc(size_t size);
+  template <class T> T* Create() { return new (Alloc(sizeof(T))) T; };
+  template <class T> T* CreateArray(size_t count)
+  {
+    T* result = static_cast<T*>(Alloc(sizeof(T) * count));
+    for (size_t i = 0; i < count; ++i) new (&result[i]) T;
+    return result;
+  };
+  void Reset();
+  void Trim(size_t maxCapacity);
+  size_t Capacity() const;
+private:
+  struct Chunk { char* Data; size_t Size; };
+  std::vector<Chunk> m_Chunks;
+  size_t m_Current; //index of the chunk being filled
+  size_t m_Used;    //bytes used in the current chunk
+  MemoryArena(const MemoryArena &);
+  MemoryArena& operator=(const MemoryArena &);
+};
+
 typedef std::vector < OutRec* > PolyOutList;
 typedef std::vector < TEdge* > EdgeList;
 typedef std::vector < Join* > JoinList;
@@ -251,6 +285,7 @@ protected:
   LocalMinima      *m_MinimaList;
   bool              m_UseFullRange;
   EdgeList          m_edges;
+  MemoryArena       m_EdgeArena; //edges and local minima, recycled by Clear()
   bool             m_PreserveCollinear;
   bool             m_HasOpenPaths;
 };
@@ -270,6 +305,9 @@ public:
     PolyFillType subjFillType = pftEvenOdd,
     PolyFillType clipFillType = pftEvenOdd);
   void Clear();
+  //clears the engine and frees the arena memory beyond maxCapacity per arena
+  void TrimMemory(size_t maxCapacity);
+  size_t MemoryCapacity() const;
   bool ReverseSolution() {return m_ReverseOutput;};
   void ReverseSolution(bool value) {m_ReverseOutput = value;};
   bool StrictlySimple() {return m_StrictSimple;};
@@ -282,6 +320,7 @@ protected:
   void Reset();
   virtual bool ExecuteInternal();
 private:
+  MemoryArena       m_OutArena; //output records, joins and intersect nodes
   PolyOutList       m_PolyOuts;
   JoinList          m_Joins;
   JoinList          m_GhostJoins;
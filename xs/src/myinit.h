@@ -19,9 +19,12 @@ extern "C" {
 #endif
 
 #define EPSILON 1e-4
+#define PI 3.141592653589793238
 #define SCALING_FACTOR 0.000001
 #define scale_(val) (val / SCALING_FACTOR)
 #define unscale(val) (val * SCALING_FACTOR)
+#define RESOLUTION 0.0125
+#define SCALED_RESOLUTION (RESOLUTION / SCALING_FACTOR)
 
 namespace Slic3r {}
 using namespace Slic3r;
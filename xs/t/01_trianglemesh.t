@@ -4,7 +4,7 @@ use strict;
 use warnings;
 
 use Slic3r::XS;
-use Test::More tests => 52;
+use Test::More tests => 53;
 
 is Slic3r::TriangleMesh::hello_world(), 'Hello world!',
     'hello world';
@@ -89,4 +89,13 @@ my $cube = {
     }
 }
 
+{
+    my $m = Slic3r::TriangleMesh->new;
+    $m->ReadFromPerl($cube->{vertices}, $cube->{facets});
+    $m->repair;
+    $m->scale(1E12);
+    eval { $m->slice([ 10 ]) };
+    like $@, qr/coordinate range/, 'slice refuses meshes exceeding the coordinate range';
+}
+
 __END__
@@ -4,7 +4,7 @@ use strict;
 use warnings;
 
 use Slic3r::XS;
-use Test::More tests => 21;
+use Test::More tests => 32;
 
 use constant PI => 4 * atan2(1, 1);
 
@@ -44,6 +44,19 @@ is_deeply $expolygon->clone->pp, [$square, $hole_in_square], 'clone';
 
 is $expolygon->area, 100*100-20*20, 'area';
 
+{
+    my @lines = map Slic3r::Line->new(@$_), (
+        [ [110,110], [190,120] ],   # inside
+        [ [110,150], [190,150] ],   # crosses the hole
+        [ [100,100], [200,100] ],   # runs along the contour
+        [ [140,140], [110,110] ],   # touches the hole
+        [ [150, 50], [150,120] ],   # starts outside
+    );
+    ok $expolygon->contains_line($lines[0]), 'contains_line';
+    ok !$expolygon->contains_line($lines[1]), 'contains_line - line crossing hole';
+    is_deeply $expolygon->contains_lines(\@lines), [1, 0, 1, 1, 0], 'contains_lines';
+}
+
 {
     my $expolygon2 = $expolygon->clone;
     $expolygon2->scale(2.5);
@@ -104,4 +117,34 @@ is $expolygon->area, 100*100-20*20, 'area';
     is_deeply $collection->[0]->clone->pp, $collection->[0]->pp, 'clone collection item';
 }
 
+{
+    my $inner = Slic3r::ExPolygon->new([ [145,145], [155,145], [155,155], [145,155] ]);  # inside the hole
+    my $far = $expolygon->clone;
+    $far->translate(1000, 0);
+    my $index = Slic3r::ExPolygon::Collection::Index->new($expolygon, $far, $inner);
+    is $index->count, 3, 'index count';
+    is $index->find_point(Slic3r::Point->new(1110, 110)), 1, 'index find_point';
+    is $index->find_point(Slic3r::Point->new(150, 150)), 2, 'index find_point in island nested in hole';
+    is_deeply $index->contains_points([ [110,110], [150,142], [500,500] ]), [1, 0, 0], 'index contains_points';
+    ok $index->contains_all_lines([ map Slic3r::Line->new(@$_), [[1110,110],[1190,110]], [[1190,110],[1190,190]] ]),
+        'index contains_all_lines';
+}
+
+{
+    my $thin = Slic3r::ExPolygon->new([ [0,0], [10000,0], [10000,500], [0,500] ]);
+    my @axis = $thin->medial_axis(500);
+    my ($longest) = sort { $b->length <=> $a->length } @axis;
+    ok !(grep !$_->isa('Slic3r::Polyline'), @axis), 'medial_axis of a strip returns polylines';
+    my $pp = $longest->pp;
+    ok $longest->length > 9000 && !(grep abs($_->[1] - 250) > 1, @$pp[1..$#$pp-1]),
+        'medial_axis runs along the middle of the strip';
+    
+    my $ring = Slic3r::ExPolygon->new(
+        [ [0,0], [5000,0], [5000,5000], [0,5000] ],
+        [ [400,400], [400,4600], [4600,4600], [4600,400] ],
+    );
+    is scalar(grep $_->isa('Slic3r::Polygon'), $ring->medial_axis(400)), 1,
+        'medial_axis of a ring returns a loop';
+}
+
 __END__
@@ -4,7 +4,7 @@ use strict;
 use warnings;
 
 use Slic3r::XS;
-use Test::More tests => 17;
+use Test::More tests => 22;
 
 my $square = [  # ccw
     [100, 100],
@@ -53,6 +53,16 @@ ok ref($polygon->first_point) eq 'Slic3r::Point', 'first_point';
 ok $polygon->contains_point(Slic3r::Point->new(150,150)), 'ccw contains_point';
 ok $cw_polygon->contains_point(Slic3r::Point->new(150,150)), 'cw contains_point';
 
+{
+    my $bb = $polygon->bounding_box;
+    isa_ok $bb, 'Slic3r::Geometry::BoundingBox';
+    is_deeply [ $bb->x_min, $bb->y_min, $bb->x_max, $bb->y_max ], [100, 100, 200, 200], 'bounding_box';
+    is_deeply $bb->size->pp, [100, 100], 'bounding_box size';
+    $bb->merge_point(Slic3r::Point->new(300, 50));
+    is_deeply [ $bb->min_point->pp, $bb->max_point->pp ], [ [100, 50], [300, 200] ], 'bounding_box merge_point';
+    ok $bb->contains_point(Slic3r::Point->new(300, 200)), 'bounding_box contains_point on border';
+}
+
 # this is not a test: this just demonstrates bad usage, where $polygon->clone gets
 # DESTROY'ed before the derived object ($point), causing bad memory access
 if (0) {
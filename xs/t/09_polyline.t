@@ -4,7 +4,7 @@ use strict;
 use warnings;
 
 use Slic3r::XS;
-use Test::More tests => 7;
+use Test::More tests => 8;
 
 my $points = [
     [100, 100],
@@ -19,6 +19,9 @@ is_deeply $polyline->pp, $points, 'polyline roundtrip';
 is ref($polyline->arrayref), 'ARRAY', 'polyline arrayref is unblessed';
 isa_ok $polyline->[0], 'Slic3r::Point::Ref', 'polyline point is blessed';
 
+is_deeply [ $polyline->first_point_xy, $polyline->last_point_xy ], [ @{$points->[0]}, @{$points->[-1]} ],
+    'endpoint coordinates as plain lists';
+
 my $lines = $polyline->lines;
 is_deeply [ map $_->pp, @$lines ], [
     [ [100, 100], [200, 100] ],
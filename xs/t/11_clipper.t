@@ -4,7 +4,7 @@ use strict;
 use warnings;
 
 use Slic3r::XS;
-use Test::More tests => 11;
+use Test::More tests => 17;
 
 my $square = [  # ccw
     [200, 100],
@@ -106,4 +106,47 @@ my $expolygon = Slic3r::ExPolygon->new($square, $hole_in_square);
     }
 }
 
+{
+    # a column of frames, large enough to be split into groups: the frames are
+    # all centered on the same X while their holes are spread along it, so
+    # most holes fall in another strip than their contour
+    my @expolygons = map Slic3r::ExPolygon->new(
+        [ [0, $_*300], [100000, $_*300], [100000, $_*300+200], [0, $_*300+200] ],
+        [ [50+$_*190, $_*300+50], [50+$_*190, $_*300+150], [150+$_*190, $_*300+150], [150+$_*190, $_*300+50] ],
+    ), 0..499;
+    my $expected = Slic3r::Geometry::Clipper::union_ex([ map @$_, @expolygons ]);
+    my $topology = sub { [ scalar(@{$_[0]}), scalar(map @{$_->holes}, @{$_[0]}) ] };
+    my $area = sub { my $a = 0; $a += $_->area for @{$_[0]}; $a };
+    
+    my $result = Slic3r::Geometry::Clipper::union_parallel_expolygons(\@expolygons, 0, 2);
+    is_deeply $topology->($result), $topology->($expected), 'union_parallel_expolygons - same topology as union_ex';
+    is $area->($result), $area->($expected), 'union_parallel_expolygons - same area as union_ex';
+    
+    $result = Slic3r::Geometry::Clipper::union_parallel_ex([ map @$_, @expolygons ], 0, 2);
+    is_deeply $topology->($result), $topology->($expected), 'union_parallel_ex - holes kept with clockwise rings';
+    is $area->($result), $area->($expected), 'union_parallel_ex - same area as union_ex';
+}
+
+{
+    # the Clipper engine is reused across calls: make sure no state leaks between them
+    my %results = ();
+    for my $i (1..1000) {
+        my $result = $i % 2
+            ? Slic3r::Geometry::Clipper::diff_ex([ $square ], [ $hole_in_square ])
+            : Slic3r::Geometry::Clipper::intersection_ex([ $square ], [ $hole_in_square ]);
+        $results{ join ',', map $_->area, @$result }++;
+    }
+    is_deeply [ sort { $a <=> $b } keys %results ], [ 400, 9600 ], 'repeated operations return stable results';
+}
+
+{
+    Slic3r::Geometry::Clipper::offset_cache_enable(16);
+    my $first  = Slic3r::Geometry::Clipper::offset([ $square ], 5);
+    my $hits   = Slic3r::Geometry::Clipper::offset_cache_stats()->{hits};
+    my $second = Slic3r::Geometry::Clipper::offset([ $square ], 5);
+    ok Slic3r::Geometry::Clipper::offset_cache_stats()->{hits} > $hits
+        && $second->[0]->area == $first->[0]->area, 'repeated offset is served from the cache';
+    Slic3r::Geometry::Clipper::offset_cache_enable(0);
+}
+
 __END__
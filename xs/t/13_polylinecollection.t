@@ -4,7 +4,7 @@ use strict;
 use warnings;
 
 use Slic3r::XS;
-use Test::More tests => 3;
+use Test::More tests => 5;
 
 {
     my $collection = Slic3r::Polyline::Collection->new(
@@ -19,6 +19,8 @@ use Test::More tests => 3;
         [ map $_->y, map @$_, @{$collection->chained_path(0)} ],
         [15, 18, 20, 10, 8, 5],
         'chained_path';
+    is_deeply $collection->endpoints, [ 0,15, 0,20, 0,10, 0,5 ], 'endpoints';
+    is_deeply $collection->endpoints(1), [ 0,15, 0,15, 0,10, 0,10 ], 'endpoints with no_reverse';
 }
 
 {
@@ -4,7 +4,7 @@ use strict;
 use warnings;
 
 use Slic3r::XS;
-use Test::More tests => 2;
+use Test::More tests => 22;
 
 {
     my @points = (
@@ -17,6 +17,81 @@ use Test::More tests => 2;
     my $hull = Slic3r::Geometry::convex_hull(\@points);
     isa_ok $hull, 'Slic3r::Polygon', 'convex_hull returns a Polygon';
     is scalar(@$hull), 4, 'convex_hull returns the correct number of points';
+    
+    my $accumulator = Slic3r::Geometry::ConvexHull->new;
+    $accumulator->append_points([ @points[0,1] ]);
+    $accumulator->append_expolygons(Slic3r::ExPolygon::Collection->new(
+        [ [ [100,100], [200,100], [200,200], [150,150] ] ],
+    ));
+    $accumulator->append_hull($accumulator, [ 0, 0 ]);
+    is $accumulator->count, 4, 'ConvexHull only keeps hull vertices';
+    is $accumulator->polygon->area, $hull->area, 'ConvexHull matches convex_hull';
+}
+
+{
+    my @points = map Slic3r::Point->new(@$_), [0,0], [10,0], [-10,0], [0,0], [100,0];
+    is_deeply Slic3r::Geometry::chained_path(\@points), [ 0, 3, 2, 1, 4 ],
+        'chained_path breaks ties like a linear nearest point scan';
+}
+
+{
+    # the nearest neighbor walk goes 0 -> 10 -> 30 -> -11
+    my @points = map Slic3r::Point->new($_ * 1000000, 0), 0, 10, -11, 30;
+    Slic3r::Geometry::travel_refinement_enable(1000);
+    is_deeply Slic3r::Geometry::chained_path(\@points), [ 0, 1, 3, 2 ],
+        'chained_path only refines travel orderings on request';
+    my $order = Slic3r::Geometry::chained_path(\@points, 1);
+    is_deeply $order, [ 2, 0, 1, 3 ], 'chained_path refines the nearest neighbor walk';
+    is Slic3r::Geometry::travel_refinement_saved(), 19000000, 'travel_refinement_saved';
+    is_deeply Slic3r::Geometry::chained_path(\@points, 1), $order,
+        'each ordering gets its own refinement budget';
+    Slic3r::Geometry::travel_refinement_enable(0);
+}
+
+{
+    my $square = Slic3r::Polygon->new([100,100], [200,100], [200,200], [100,200]);  # ccw
+    my $hole = Slic3r::Polygon->new([140,140], [140,160], [160,160], [160,140]);    # cw
+    is_deeply Slic3r::Geometry::polygons_area([ $square, $hole, [ @$square ] ]), [ 10000, -400, 10000 ],
+        'polygons_area returns signed areas';
+    
+    my $big = 2_000_000_000;
+    my $huge = Slic3r::Polygon->new([-$big,-$big], [$big,-$big], [$big,$big], [-$big,$big]);
+    ok $huge->is_counter_clockwise, 'orientation is exact for large coordinates';
+    
+    my $small = Slic3r::ExPolygon->new([ [0,0], [10,0], [10,10], [0,10] ]);
+    my $framed = Slic3r::ExPolygon->new($square, $hole);
+    my $result = Slic3r::Geometry::filter_by_min_area([ $small, $framed, $small ], 1000);
+    is scalar(@$result), 1, 'filter_by_min_area drops small items';
+    is $result->[0], $framed, 'filter_by_min_area returns the same objects';
+}
+
+{
+    my $points = [ [0,0], [50,50], [100,0], [125,-25], [150,50] ];
+    is_deeply [ map $_->pp, @{Slic3r::Geometry::douglas_peucker($points, 25)} ],
+        [ [0, 0], [50, 50], [125, -25], [150, 50] ], 'douglas_peucker';
+    
+    my $polylines = Slic3r::Geometry::douglas_peucker_polylines([ Slic3r::Polyline->new(@$points), $points ], 25);
+    is_deeply [ map $_->pp, @$polylines ], [ ([ [0, 0], [50, 50], [125, -25], [150, 50] ]) x 2 ],
+        'douglas_peucker_polylines';
+    
+    # the cross product of the middle point wraps around a 64-bit integer
+    $points = [ [0,0], [2000000000,4611686018], [4000000000,0] ];
+    is scalar(@{Slic3r::Geometry::douglas_peucker($points, 1000000)}), 3,
+        'douglas_peucker keeps far points on large coordinates';
+}
+
+{
+    my $square = [ [100,100], [200,100], [200,200], [100,200] ];
+    is_deeply [ map Slic3r::Geometry::point_in_polygon($_, $square), [150,150], [250,150], [150,100] ],
+        [ 1, 0, 1 ], 'point_in_polygon';
+    is_deeply [ map Slic3r::Geometry::point_in_segment($_, Slic3r::Line->new([100,100], [200,200])), [150,150], [150,100] ],
+        [ 1, 0 ], 'point_in_segment';
+    is_deeply Slic3r::Geometry::line_intersection([ [5,15], [30,15] ], [ [10,20], [10,10] ], 1)->pp, [10, 15],
+        'line_intersection';
+    is_deeply [ map $_->pp, Slic3r::Geometry::polygon_lines(Slic3r::Polygon->new(@$square[0..2])) ],
+        [ [ [100,100], [200,100] ], [ [200,100], [200,200] ], [ [200,200], [100,100] ] ], 'polygon_lines';
+    is_deeply [ Slic3r::Geometry::rotate_points(Slic3r::Geometry::deg2rad(180), [0,0], [10,-5]) ], [ [-10,5] ],
+        'rotate_points';
 }
 
 __END__
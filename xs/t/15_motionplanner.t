@@ -0,0 +1,33 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+
+use Slic3r::XS;
+use Test::More tests => 5;
+
+use constant SCALING_FACTOR => 0.000001;
+
+{
+    my $mp = Slic3r::GCode::MotionPlanner->new(islands => []);
+    my $path = $mp->shortest_path(map Slic3r::Point->new(@$_), [0,0], [100,100]);
+    is_deeply $path->pp, [ [0,0], [100,100] ], 'no islands: straight travel';
+}
+
+{
+    # U-shaped island: travels between the arms must go around the bottom
+    my $island = Slic3r::ExPolygon->new(
+        [ map [ map $_ / SCALING_FACTOR, @$_ ], [0,0], [30,0], [30,30], [20,30], [20,10], [10,10], [10,30], [0,30] ],
+    );
+    my $mp = Slic3r::GCode::MotionPlanner->new(islands => [ $island ]);
+    my ($from, $to) = map Slic3r::Point->new(map $_ / SCALING_FACTOR, @$_), [5,25], [25,25];
+    my $path = $mp->shortest_path($from, $to);
+    
+    ok $path->first_point->coincides_with($from) && $path->last_point->coincides_with($to),
+        'path joins the requested points';
+    ok $path->length > $from->distance_to($to) * 2, 'path avoids the gap';
+    ok !(grep !$island->contains_line($_), @{$path->lines}), 'path stays inside the island';
+    is $mp->last_crossings, 0, 'no perimeter crossed';
+}
+
+__END__
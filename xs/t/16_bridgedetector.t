@@ -0,0 +1,62 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+
+use Slic3r::XS;
+use Test::More tests => 8;
+
+use constant SCALING_FACTOR => 0.000001;
+
+sub rectangle {
+    my ($x1, $y1, $x2, $y2) = map $_ / SCALING_FACTOR, @_;
+    return Slic3r::ExPolygon->new([ [$x1,$y1], [$x2,$y1], [$x2,$y2], [$x1,$y2] ]);
+}
+
+my $bridge = rectangle(0,0,10,10);
+my $width = 0.5 / SCALING_FACTOR;
+
+{
+    my $bd = Slic3r::BridgeDetector->new(
+        expolygon       => $bridge,
+        lower_slices    => [ rectangle(-5,-5,0,15), rectangle(10,-5,15,15) ],
+        extrusion_width => $width,
+    );
+    ok $bd->detect_angle, 'bridge between two supports';
+    ok abs($bd->angle) < 0.01, 'bridge lines go from one support to the other';
+    ok $bd->coverage > 0, 'bridge has coverage';
+}
+
+{
+    # two small supports in the middle of the other sides don't change the direction
+    my $bd = Slic3r::BridgeDetector->new(
+        expolygon       => $bridge,
+        lower_slices    => [ rectangle(-5,-5,0,15), rectangle(10,-5,15,15), rectangle(4,-5,6,0), rectangle(4,10,6,15) ],
+        extrusion_width => $width,
+    );
+    is $bd->edges_count, 4, 'supporting edges detected';
+    ok $bd->detect_angle && abs($bd->angle) < 0.01, 'best angle found among candidates';
+}
+
+{
+    my $bd = Slic3r::BridgeDetector->new(
+        expolygon       => $bridge,
+        lower_slices    => [],
+        extrusion_width => $width,
+    );
+    ok !$bd->detect_angle, 'no angle without supports';
+}
+
+{
+    # test lines end half the extrusion width within the anchors, whatever their spacing
+    my $bd = Slic3r::BridgeDetector->new(
+        expolygon       => $bridge,
+        lower_slices    => [ rectangle(-5,-5,0,15), rectangle(10,-5,15,15) ],
+        extrusion_width => $width,
+        line_spacing    => 2 * $width,
+    );
+    ok $bd->detect_angle && $bd->coverage > 0, 'bridge detected with a line spacing wider than the anchors';
+    is $bd->coverage % ((10 + 0.5) / SCALING_FACTOR), 0, 'test lines are clipped within the anchors';
+}
+
+__END__
@@ -0,0 +1,92 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+
+use Slic3r::XS;
+use Test::More tests => 24;
+
+my $square = Slic3r::ExPolygon->new([ [0,0], [20000000,0], [20000000,20000000], [0,20000000] ]);
+
+{
+    my ($line_spacing, @polylines) = Slic3r::Fill::fill_rectilinear($square, 500000, 1, 0, 0, 1);
+    is $line_spacing, 500000, 'solid spacing fits the square';
+    is scalar(@polylines), 41, 'one line every spacing';
+    ok !(grep { $_->first_point->x != $_->last_point->x } @polylines), 'lines are vertical';
+    ok !(grep { $_->length != 20000000 } @polylines), 'lines span the whole square';
+    
+    my $hits = Slic3r::Fill::cache_stats()->{hits};
+    my (undef, @again) = Slic3r::Fill::fill_rectilinear($square->clone, 500000, 1, 0, 0, 1);
+    is Slic3r::Fill::cache_stats()->{hits}, $hits + 1, 'same surface reuses the previous infill';
+    is_deeply [ map $_->pp, @again ], [ map $_->pp, @polylines ], 'reused infill is the same';
+    
+    Slic3r::Fill::cache_clear();
+    my $misses = Slic3r::Fill::cache_stats()->{misses};
+    Slic3r::Fill::fill_rectilinear($square->clone, 500000, 1, 0, 0, 1);
+    is Slic3r::Fill::cache_stats()->{misses}, $misses + 1, 'cache_clear forgets the previous infill';
+}
+
+{
+    my (undef, @polylines) = Slic3r::Fill::fill_rectilinear($square, 500000, 1, 0, 0, 0);
+    is scalar(@polylines), 1, 'lines are connected into a single zig-zag';
+}
+
+{
+    my $expolygon = Slic3r::ExPolygon->new(
+        [ [0,0], [20000000,0], [20000000,20000000], [0,20000000] ],
+        [ [5000000,5000000], [5000000,15000000], [15000000,15000000], [15000000,5000000] ],
+    );
+    my (undef, @polylines) = Slic3r::Fill::fill_rectilinear($expolygon, 500000, 1, 0, 0, 1);
+    ok !(grep {
+        my $p = Slic3r::Line->new($_->first_point, $_->last_point)->midpoint;
+        $p->x > 5000000 && $p->x < 15000000 && $p->y > 5000000 && $p->y < 15000000
+    } @polylines), 'no line crosses the hole';
+}
+
+{
+    my ($distance, @loops) = Slic3r::Fill::fill_concentric($square, 500000, 1, 0);
+    is $distance, 500000, 'concentric spacing fits the square';
+    is scalar(@loops), 20, 'one loop every spacing';
+    ok !(grep { $loops[$_]->length >= $loops[$_-1]->length } 1..$#loops), 'loops go from the outermost to the innermost';
+    
+    my (undef, @parallel) = Slic3r::Fill::fill_concentric($square, 500000, 1, 0, 0);
+    is_deeply [ map $_->length, @parallel ], [ map $_->length, @loops ], 'levels offset from the outermost loop';
+    (undef, @parallel) = Slic3r::Fill::fill_concentric($square, 500000, 1, 0, 0, 1);
+    is_deeply [ map $_->length, @parallel ], [ map $_->length, @loops ], 'levels offset from the outermost loop in one thread';
+}
+
+{
+    my $tiny = Slic3r::ExPolygon->new([ [0,0], [100000,0], [100000,100000], [0,100000] ]);
+    my (undef, @loops) = Slic3r::Fill::fill_concentric($tiny, 500000, 1, 1);
+    is scalar(@loops), 0, 'no loop in a surface vanishing under the overlap';
+    (undef, @loops) = Slic3r::Fill::fill_concentric($tiny, 500000, 1, 1, 0);
+    is scalar(@loops), 0, 'no loop in a vanishing surface with parallel levels';
+}
+
+{
+    my @paths = Slic3r::Fill::fill_honeycomb($square, 500000, 0.2, 0, 0);
+    ok scalar(@paths), 'honeycomb infill generated';
+    my $grown = Slic3r::ExPolygon->new([ [-1000,-1000], [20001000,-1000], [20001000,20001000], [-1000,20001000] ]);
+    ok !(grep { my $p = $_; grep !$grown->contains_point($_), @$p } @paths), 'honeycomb stays within the surface';
+    
+    my $hits = Slic3r::Fill::cache_stats()->{pattern_hits};
+    my @again = Slic3r::Fill::fill_honeycomb($square->clone, 500000, 0.2, 0, 0);
+    is Slic3r::Fill::cache_stats()->{pattern_hits}, $hits + 1, 'same window reuses the honeycomb pattern';
+    
+    my @loops = Slic3r::Fill::fill_honeycomb($square, 500000, 0.2, 0, 1);
+    ok !(grep !$_->first_point->coincides_with($_->last_point), @loops), 'complete honeycomb loops are closed';
+}
+
+{
+    my $grown = Slic3r::ExPolygon->new([ [-1000,-1000], [20001000,-1000], [20001000,20001000], [-1000,20001000] ]);
+    my %paths = ();
+    for my $curve (qw(HilbertCurve ArchimedeanChords OctagramSpiral)) {
+        $paths{$curve} = [ Slic3r::Fill::fill_plane_path($square, 1000000, $curve) ];
+        ok @{$paths{$curve}} && !(grep { my $p = $_; grep !$grown->contains_point($_), @$p } @{$paths{$curve}}),
+            "$curve infill stays within the surface";
+    }
+    ok !(grep { my $p = $_; grep $p->[$_]->x != $p->[$_-1]->x && $p->[$_]->y != $p->[$_-1]->y, 1..$#$p } @{$paths{HilbertCurve}}),
+        'Hilbert curve steps are straight';
+}
+
+__END__
@@ -0,0 +1,81 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+
+use Slic3r::XS;
+use Test::More tests => 13;
+
+use constant SCALING_FACTOR => 0.000001;
+
+sub rectangle {
+    my ($x1, $y1, $x2, $y2) = map $_ / SCALING_FACTOR, @_;
+    return [ [$x1,$y1], [$x2,$y1], [$x2,$y2], [$x1,$y2] ];
+}
+
+sub slices {
+    return Slic3r::Surface::Collection->new(
+        map Slic3r::Surface->new(expolygon => $_, surface_type => Slic3r::Surface::S_TYPE_INTERNAL), @_,
+    );
+}
+
+sub generate {
+    my ($slices, %args) = @_;
+    
+    my $generator = Slic3r::Layer::PerimeterGenerator->new(
+        slices                  => $slices,
+        perimeter_width         => 0.5 / SCALING_FACTOR,
+        perimeter_spacing       => 0.45 / SCALING_FACTOR,
+        solid_infill_spacing    => 0.45 / SCALING_FACTOR,
+        flow_spacing            => 0.45,
+        perimeters              => 3,
+        %args,
+    );
+    my $loops = Slic3r::ExtrusionPath::Collection->new;
+    my $fill_surfaces = Slic3r::Surface::Collection->new;
+    $generator->process($loops, $fill_surfaces);
+    return ($loops, $fill_surfaces, $generator->gaps, $generator);
+}
+
+{
+    my $square_with_hole = Slic3r::ExPolygon->new(
+        rectangle(0,0,20,20),
+        [ reverse @{rectangle(7,7,13,13)} ],
+    );
+    my ($loops, $fill_surfaces) = generate(slices($square_with_hole));
+    is scalar(@$loops), 6, 'three loops around the contour and three around the hole';
+    is scalar(grep $_->role == Slic3r::ExtrusionPath::EXTR_ROLE_EXTERNAL_PERIMETER, @$loops), 2,
+        'external perimeters';
+    ok !(grep $_->flow_spacing != 0.45, @$loops), 'flow spacing';
+    is scalar(grep $_->polygon->is_counter_clockwise, @$loops), 3, 'ccw contours and cw holes';
+    is $loops->[-1]->role, Slic3r::ExtrusionPath::EXTR_ROLE_EXTERNAL_PERIMETER, 'loops ordered from inner to outer';
+    is scalar(@$fill_surfaces), 1, 'one fill surface';
+    
+    ($loops) = generate(slices($square_with_hole), outer_first => 1);
+    is $loops->[0]->role, Slic3r::ExtrusionPath::EXTR_ROLE_EXTERNAL_PERIMETER, 'outer loops first';
+}
+
+{
+    my $thin_wall = Slic3r::ExPolygon->new(rectangle(0,0,10,0.6));
+    my ($loops) = generate(slices($thin_wall), thin_walls => 1);
+    ok scalar(grep $_->isa('Slic3r::ExtrusionPath'), @$loops), 'thin wall extruded along its medial axis';
+}
+
+{
+    my $narrow_strip = Slic3r::ExPolygon->new(rectangle(0,0,10,1.6));
+    my (undef, undef, $gaps) = generate(slices($narrow_strip), gap_fill => 1);
+    ok scalar(@$gaps), 'gap found between loops';
+    (undef, undef, $gaps) = generate(slices($narrow_strip));
+    ok !@$gaps, 'no gaps unless requested';
+    
+    my (undef, undef, undef, $generator) = generate(slices($narrow_strip), gap_fill => 1);
+    my $thin_fills = Slic3r::ExtrusionPath::Collection->new;
+    my $stats = Slic3r::Fill::cache_stats();
+    $generator->fill_gaps($thin_fills, [ 0.5 / SCALING_FACTOR, 0.2 / SCALING_FACTOR ], [ 0.45, 0.18 ], 0, 0.4);
+    ok scalar(@$thin_fills), 'gap filled';
+    is_deeply Slic3r::Fill::cache_stats(), $stats, 'gap fill bypasses the infill cache';
+    ok !(grep $_->role != Slic3r::ExtrusionPath::EXTR_ROLE_GAPFILL || @{$_->polyline} != 2 || $_->height != 0.4, @$thin_fills),
+        'gap fill made of single segments';
+}
+
+__END__
@@ -0,0 +1,55 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+
+use Slic3r::XS;
+use Test::More tests => 7;
+
+use constant SCALING_FACTOR => 0.000001;
+
+sub rectangle {
+    my ($x1, $y1, $x2, $y2) = map $_ / SCALING_FACTOR, @_;
+    return Slic3r::ExPolygon->new([ [$x1,$y1], [$x2,$y1], [$x2,$y2], [$x1,$y2] ]);
+}
+
+sub types {
+    my ($collection) = @_;
+    return [ sort map $_->surface_type, @$collection ];
+}
+
+# a 20x20 block with a 10x10 step on top of it
+my @layers = ([0,0,20,20], [0,0,20,20], [0,0,10,10]);
+my @layer_slices = map [ rectangle(@$_) ], @layers;
+
+my @slices = map Slic3r::Surface::Collection->new(
+    Slic3r::Surface->new(expolygon => $_->[0], surface_type => Slic3r::Surface::S_TYPE_INTERNAL),
+), @layer_slices;
+
+# fill boundaries are 1mm inside the slices
+my @fill_surfaces = map Slic3r::Surface::Collection->new(
+    Slic3r::Surface->new(
+        expolygon       => rectangle($_->[0] + 1, $_->[1] + 1, $_->[2] - 1, $_->[3] - 1),
+        surface_type    => Slic3r::Surface::S_TYPE_INTERNAL,
+    ),
+), @layers;
+
+# the detector doesn't own the collections, so keep them around
+my @layer_collections = map Slic3r::ExPolygon::Collection->new(@$_), @layer_slices;
+
+my $detector = Slic3r::SurfaceTypeDetector->new;
+$detector->add_layer($slices[$_], $layer_collections[$_], 0.05 / SCALING_FACTOR, $fill_surfaces[$_])
+    for 0..$#layer_slices;
+$detector->detect;
+
+is_deeply types($slices[0]), [ Slic3r::Surface::S_TYPE_BOTTOM ], 'first layer is bottom';
+is_deeply types($slices[1]), [ Slic3r::Surface::S_TYPE_TOP, Slic3r::Surface::S_TYPE_INTERNAL ],
+    'layer below the step has top and internal surfaces';
+ok abs($slices[1]->filter_by_type(Slic3r::Surface::S_TYPE_TOP)->[0]->area - 300 / SCALING_FACTOR**2) < 1 / SCALING_FACTOR**2,
+    'top surface is not covered by the step';
+is_deeply types($slices[2]), [ Slic3r::Surface::S_TYPE_TOP ], 'last layer is top';
+is_deeply types($fill_surfaces[1]), types($slices[1]), 'fill surfaces take the types of the slices';
+ok $fill_surfaces[1]->[0]->area < $slices[1]->[0]->area, 'fill surfaces are clipped to the fill boundaries';
+is_deeply types($fill_surfaces[2]), [ Slic3r::Surface::S_TYPE_TOP ], 'fill surfaces of the last layer';
+
+__END__
@@ -0,0 +1,50 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+
+use Slic3r::XS;
+use Test::More tests => 9;
+
+my @expolygons = (
+    Slic3r::ExPolygon->new(
+        [ [0,0], [3000000,0], [3000000,2000000], [0,2000000] ],
+        [ [1000000,500000], [1000000,1500000], [2000000,1500000], [2000000,500000] ],
+    ),
+    Slic3r::ExPolygon->new([ [5000000,1000000], [7000000,1000000], [6000000,4000000] ]),
+);
+my $set = Slic3r::Geometry::PolygonSet->new(@expolygons);
+
+is $set->count, 3, 'one ring per contour and hole';
+is $set->points_count, 11, 'all points stored';
+is_deeply [ map $_->pp, @{$set->expolygons} ], [ map $_->pp, @expolygons ], 'expolygons round trip';
+is_deeply $set->group_areas, [ map $_->area, @expolygons ], 'group areas match ExPolygon::area';
+is_deeply $set->areas, [ map $_->area, map @$_, @expolygons ], 'ring areas match Polygon::area';
+
+{
+    my $bb = $set->bounding_box;
+    is_deeply [ $bb->x_min, $bb->y_min, $bb->x_max, $bb->y_max ], [ 0, 0, 7000000, 4000000 ], 'bounding box';
+}
+
+{
+    $set->translate(150, -250);
+    is_deeply [ map $_->pp, @{$set->expolygons} ],
+        [ map { my $e = $_->clone; $e->translate(150, -250); $e->pp } @expolygons ], 'translate';
+}
+
+{
+    my $set = Slic3r::Geometry::PolygonSet->new(@expolygons);
+    my $center = Slic3r::Point->new(1000000, 2000000);
+    $set->rotate(0.3, $center);
+    is_deeply [ map $_->pp, @{$set->expolygons} ],
+        [ map { my $e = $_->clone; $e->rotate(0.3, $center); $e->pp } @expolygons ], 'rotate matches ExPolygon::rotate';
+}
+
+{
+    my $set = Slic3r::Geometry::PolygonSet->new(@expolygons);
+    $set->scale(0.7);
+    is_deeply [ map $_->pp, @{$set->expolygons} ],
+        [ map { my $e = $_->clone; $e->scale(0.7); $e->pp } @expolygons ], 'scale matches ExPolygon::scale';
+}
+
+__END__